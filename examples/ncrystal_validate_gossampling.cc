@@ -0,0 +1,167 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  This file is part of NCrystal (see https://mctools.github.io/ncrystal/)   //
+//                                                                            //
+//  Copyright 2015-2020 NCrystal developers                                   //
+//                                                                            //
+//  Licensed under the Apache License, Version 2.0 (the "License");           //
+//  you may not use this file except in compliance with the License.          //
+//  You may obtain a copy of the License at                                   //
+//                                                                            //
+//      http://www.apache.org/licenses/LICENSE-2.0                            //
+//                                                                            //
+//  Unless required by applicable law or agreed to in writing, software       //
+//  distributed under the License is distributed on an "AS IS" BASIS,         //
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  //
+//  See the License for the specific language governing permissions and       //
+//  limitations under the License.                                            //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+//                                                                              //
+// Consistency check for the rejection sampling in GaussOnSphere::              //
+// genPointOnCircle, which for most parameters samples the position on the      //
+// circle via a Gaussian overlay function. Here it is compared to a simple      //
+// reference sampler using a flat overlay (this was the algorithm used before   //
+// the Gaussian overlay was introduced). For a range of mosaicities, truncation //
+// angles and geometries, histograms of the sampled positions on the circle are //
+// compared with a two-sample chi-square test. The program also reports the     //
+// time spent per sampled point by both methods. It returns a non-zero exit     //
+// code if the histograms are inconsistent. It is only built when CMake is run  //
+// with -DBUILD_VALIDATION=ON, and is run by "make validate".                   //
+//                                                                              //
+// Note that this file uses internal NCrystal header files, for which no        //
+// long-term API stability is guaranteed.                                       //
+//                                                                              //
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "NCrystal/NCrystal.hh"
+#include "NCrystal/internal/NCGaussOnSphere.hh"
+#include "NCrystal/internal/NCMath.hh"
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cmath>
+
+namespace NC = NCrystal;
+
+namespace {
+
+  //Reference sampler: t uniform in [0,tmax], rejected against the density at
+  //t=0, and finally a random sign of t. Returns false for vanishing density:
+  bool refGenPointOnCircle( const NC::GaussOnSphere& gos, NC::RandomBase* rand,
+                            double cg, double sg, double ca, double sa, double& t )
+  {
+    const double sasg = sa*sg;
+    const double cacg = ca*cg;
+    const double cd = cacg+sasg;
+    const double cta = gos.getCosTruncangle();
+    if ( cd<=cta || sasg<1e-14 )
+      return false;
+    const double cos_tmax = (cta-cacg)/sasg;
+    if (cos_tmax>=1.0)
+      return false;
+    const double tmax = ( cos_tmax<=-1.0 ? NC::kPi : std::acos(cos_tmax) );
+    const double densitymax = gos.evalCosXInRange(cd)*1.00000001;
+    for (int i = 0; i < 1000; ++i) {
+      t = rand->generate()*tmax;
+      if ( gos.evalCosXInRange(sasg*std::cos(t)+cacg) > densitymax * rand->generate() ) {
+        if (rand->generate()>0.5)
+          t = -t;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  struct Config {
+    double sigma_deg;//mosaicity (gaussian sigma)
+    double ntrunc;//truncation angle in units of sigma
+    double gamma_deg;//angle between gaussian center and circle axis
+    double dalpha_deg;//circle opening angle minus gamma
+  };
+
+}
+
+int main()
+{
+  const Config configs[] = { { 0.1, 3.5, 30.0, 0.0 },
+                             { 0.1, 3.5, 30.0, 0.1 },
+                             { 0.1, 3.5, 30.0, 0.25 },
+                             { 0.1, 3.5, 30.0, 0.34 },
+                             { 0.1, 3.5, 80.0, 0.05 },
+                             { 3.0, 3.5, 45.0, 1.0 },
+                             { 3.0, 3.5, 10.0, 8.0 },
+                             { 10.0/3600, 5.0, 60.0, 1.0/3600 },
+                             { 1.0/3600, 3.5, 45.0, 0.5/3600 },
+                             { 1.0, 3.5, 2.0, 1.5 },
+                             { 5.0, 3.0, 50.0, 0.0 },
+                             { 0.5, 8.0, 30.0, 0.5 } };
+  const unsigned nsample = 500000;
+  const unsigned nbins = 40;
+  //chi2/ndf for 40 degrees of freedom has a standard deviation of about 0.22,
+  //so this is a >5 sigma threshold:
+  const double chi2ndf_max = 2.2;
+
+  NC::RCHolder<NC::RandomBase> rng_new(new NC::RandXRSR(1234));
+  NC::RCHolder<NC::RandomBase> rng_ref(new NC::RandXRSR(5678));
+  bool all_ok = true;
+
+  for ( const auto& c : configs ) {
+    const double sigma = c.sigma_deg * NC::kDeg;
+    NC::GaussOnSphere gos( sigma, c.ntrunc * sigma, 1e-3 );
+    const double gamma = c.gamma_deg * NC::kDeg;
+    const double alpha = ( c.gamma_deg + c.dalpha_deg ) * NC::kDeg;
+    const double cg = std::cos(gamma), sg = std::sin(gamma);
+    const double ca = std::cos(alpha), sa = std::sin(alpha);
+    const double cos_tmax = ( gos.getCosTruncangle() - ca*cg ) / ( sa*sg );
+    const double tmax = ( cos_tmax<=-1.0 ? NC::kPi : std::acos(cos_tmax) );
+    auto binIdx = [tmax,nbins](double t) {
+      int ibin = int( ( t + tmax ) / ( 2.0 * tmax ) * nbins );
+      return unsigned( ibin < 0 ? 0 : ( ibin >= int(nbins) ? nbins - 1 : ibin ) );
+    };
+
+    std::vector<double> hist_new(nbins,0.0), hist_ref(nbins,0.0);
+    auto t0 = std::chrono::steady_clock::now();
+    for ( unsigned i = 0; i < nsample; ++i ) {
+      double ct, st;
+      if ( gos.genPointOnCircle( rng_new.obj(), cg, sg, ca, sa, ct, st ) )
+        hist_new[binIdx(std::atan2(st,ct))] += 1.0;
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for ( unsigned i = 0; i < nsample; ++i ) {
+      double t;
+      if ( refGenPointOnCircle( gos, rng_ref.obj(), cg, sg, ca, sa, t ) )
+        hist_ref[binIdx(t)] += 1.0;
+    }
+    auto t2 = std::chrono::steady_clock::now();
+
+    double chi2 = 0.0, sum_new = 0.0, sum_ref = 0.0;
+    unsigned ndf = 0;
+    for ( unsigned i = 0; i < nbins; ++i ) {
+      sum_new += hist_new[i];
+      sum_ref += hist_ref[i];
+    }
+    for ( unsigned i = 0; i < nbins; ++i ) {
+      if ( hist_new[i] + hist_ref[i] <= 0.0 )
+        continue;
+      //Two-sample chi-square, allowing for different total counts:
+      const double d = hist_new[i] * std::sqrt(sum_ref/sum_new) - hist_ref[i] * std::sqrt(sum_new/sum_ref);
+      chi2 += d*d / ( hist_new[i] + hist_ref[i] );
+      ++ndf;
+    }
+    const double chi2ndf = ( ndf ? chi2 / ndf : 0.0 );
+    const bool ok = ( sum_new == sum_ref && chi2ndf < chi2ndf_max );
+    all_ok = all_ok && ok;
+    auto nsPerCall = [nsample](std::chrono::steady_clock::duration dt)
+                     { return std::chrono::duration<double,std::nano>(dt).count() / nsample; };
+    std::cout << "sigma="<<c.sigma_deg<<"deg truncangle="<<c.ntrunc<<"sigma gamma="<<c.gamma_deg
+              <<"deg alpha-gamma="<<c.dalpha_deg<<"deg: chi2/ndf="<<chi2ndf<<" (ndf="<<ndf<<")"
+              <<" samples="<<sum_new<<"/"<<sum_ref
+              <<" time="<<nsPerCall(t1-t0)<<"/"<<nsPerCall(t2-t1)<<" ns/call (new/ref) "
+              <<(ok?"OK":"FAILED")<<std::endl;
+  }
+  std::cout << ( all_ok ? "All checks passed." : "Some checks FAILED!" ) << std::endl;
+  return all_ok ? 0 : 1;
+}
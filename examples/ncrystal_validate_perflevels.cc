@@ -0,0 +1,144 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  This file is part of NCrystal (see https://mctools.github.io/ncrystal/)   //
+//                                                                            //
+//  Copyright 2015-2020 NCrystal developers                                   //
+//                                                                            //
+//  Licensed under the Apache License, Version 2.0 (the "License");           //
+//  you may not use this file except in compliance with the License.          //
+//  You may obtain a copy of the License at                                   //
+//                                                                            //
+//      http://www.apache.org/licenses/LICENSE-2.0                            //
+//                                                                            //
+//  Unless required by applicable law or agreed to in writing, software       //
+//  distributed under the License is distributed on an "AS IS" BASIS,         //
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  //
+//  See the License for the specific language governing permissions and       //
+//  limitations under the License.                                            //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+//                                                                              //
+// Check of the accuracy levels selected with the "perf" configuration          //
+// parameter. For a selection of materials, scattering cross sections are       //
+// evaluated over a range of neutron wavelengths (and directions, for single    //
+// crystals) with each of perf=default, perf=fast and perf=fastest, and         //
+// compared to those obtained with perf=reference. The deviation of the         //
+// averaged cross section and the average of the absolute deviations (both      //
+// relative to the averaged reference cross section) are reported together      //
+// with initialisation and evaluation times. The program returns a non-zero     //
+// exit code if the averaged absolute deviations exceed the bounds documented   //
+// for the perf parameter in NCMatCfg.hh. As perf=reference is slow, it is only //
+// built when CMake is run with -DBUILD_VALIDATION=ON, and is run by "make      //
+// validate".                                                                   //
+//                                                                              //
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "NCrystal/NCrystal.hh"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+  struct Material {
+    const char * cfgstr;
+    bool oriented;
+    unsigned npoints;
+  };
+
+  struct Result {
+    std::vector<double> xs;
+    double t_init;//seconds
+    double t_eval;//microseconds per cross section evaluation
+  };
+
+  Result evaluate( const std::string& cfgstr, bool oriented, unsigned npoints )
+  {
+    typedef std::chrono::steady_clock clock;
+    Result res;
+    auto t0 = clock::now();
+    const NCrystal::Scatter * sc = NCrystal::createScatter( cfgstr );
+    sc->ref();
+    auto t1 = clock::now();
+    res.xs.reserve(npoints);
+    for ( unsigned i = 0; i < npoints; ++i ) {
+      //Wavelengths in [0.5Aa,6.0Aa], and directions on a golden angle spiral:
+      const double wl = 0.5 + 5.5 * ( i + 0.5 ) / npoints;
+      const double ekin = NCrystal::wl2ekin(wl);
+      if (oriented) {
+        const double cz = 1.0 - 2.0 * ( i + 0.5 ) / npoints;
+        const double sz = std::sqrt( 1.0 - cz*cz );
+        const double phi = 2.39996322972865332 * i;
+        const double dir[3] = { sz*std::cos(phi), sz*std::sin(phi), cz };
+        res.xs.push_back( sc->crossSection( ekin, dir ) );
+      } else {
+        res.xs.push_back( sc->crossSectionNonOriented( ekin ) );
+      }
+    }
+    auto t2 = clock::now();
+    sc->unref();
+    res.t_init = std::chrono::duration<double>(t1-t0).count();
+    res.t_eval = std::chrono::duration<double,std::micro>(t2-t1).count() / npoints;
+    return res;
+  }
+
+}
+
+int main()
+{
+  NCrystal::libClashDetect();//Detect broken installation
+
+  const char * sc_ge = "Ge_sg227.ncmat;mos=40arcsec"
+                       ";dir1=@crys_hkl:5,1,1@lab:0,0,1;dir2=@crys_hkl:0,-1,1@lab:0,1,0";
+  const char * sc_pg = "C_sg194_pyrolytic_graphite.ncmat;mos=2.5deg;lcaxis=0,0,1"
+                       ";dir1=@crys_hkl:0,0,1@lab:0,0,1;dir2=@crys_hkl:1,0,0@lab:0,1,0";
+  const Material materials[] = { { "Al_sg225.ncmat", false, 2000 },
+                                 { "Al2O3_sg167_Corundum.ncmat", false, 2000 },
+                                 { "Be_sg194.ncmat", false, 2000 },
+                                 { "LiquidWaterH2O_T293.6K.ncmat", false, 2000 },
+                                 { sc_ge, true, 2000 },
+                                 //Layered crystals are very slow with perf=reference:
+                                 { sc_pg, true, 200 } };
+
+  //Bounds on the average absolute deviation from perf=reference, relative to
+  //the average reference cross section (as documented in NCMatCfg.hh):
+  struct Level { const char * name; double maxdev; double maxdev_sc; };
+  const Level levels[] = { { "default", 0.002, 0.005 },
+                           { "fast", 0.006, 0.01 },
+                           { "fastest", 0.015, 0.04 } };
+
+  bool all_ok = true;
+  for ( const auto& m : materials ) {
+    const std::string cfgbase(m.cfgstr);
+    Result ref = evaluate( cfgbase + ";perf=reference", m.oriented, m.npoints );
+    double sum_ref = 0.0;
+    for ( auto x : ref.xs )
+      sum_ref += x;
+    std::cout << cfgbase << ":" << std::endl;
+    std::cout << "  " << std::setw(10) << std::left << "reference" << ": init " << ref.t_init << " s, "
+              << ref.t_eval << " us/xs" << std::endl;
+    for ( const auto& lvl : levels ) {
+      Result res = evaluate( cfgbase + ";perf=" + lvl.name, m.oriented, m.npoints );
+      double sum = 0.0, sum_absdev = 0.0;
+      for ( std::size_t i = 0; i < res.xs.size(); ++i ) {
+        sum += res.xs.at(i);
+        sum_absdev += std::fabs( res.xs.at(i) - ref.xs.at(i) );
+      }
+      const double dev_avg = ( sum - sum_ref ) / sum_ref;
+      const double dev_absavg = sum_absdev / sum_ref;
+      const double maxdev = ( m.oriented ? lvl.maxdev_sc : lvl.maxdev );
+      const bool ok = ( dev_absavg <= maxdev );
+      all_ok = all_ok && ok;
+      std::cout << "  " << std::setw(10) << std::left << lvl.name << ": init " << res.t_init << " s, "
+                << res.t_eval << " us/xs, deviation of average " << dev_avg * 100.0
+                << "%, average abs. deviation " << dev_absavg * 100.0 << "% (bound: "
+                << maxdev * 100.0 << "%) " << ( ok ? "OK" : "FAILED" ) << std::endl;
+    }
+  }
+  std::cout << ( all_ok ? "All checks passed." : "Some checks FAILED!" ) << std::endl;
+  return all_ok ? 0 : 1;
+}
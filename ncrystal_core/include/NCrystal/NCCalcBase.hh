@@ -47,8 +47,11 @@ namespace NCrystal {
     //way to do this globally). Sub-calcs will have their RNG changed as well:
     void setRandomGenerator(RandomBase* rg);
 
-    //Access current RNG (the first will init and return default RNG if none was
-    //set explicitly - this modifies a mutable data member):
+    //Access current RNG (the first will return the default RNG of the calling
+    //thread if none was set explicitly, see threadDefaultRandomGenerator in
+    //NCRandom.hh). Note that this does not make it safe to use instances from
+    //several threads concurrently, since some derived classes (e.g. SCBragg and
+    //LCBragg) use unsynchronised internal caches:
     RandomBase* getRNG() const;//always returns valid object
     RandomBase* getRNGNoDefault() const;//returns null ptr if RNG was not set explicitly
 
@@ -65,7 +68,6 @@ namespace NCrystal {
     std::string m_name;
     mutable RCHolder<RandomBase> m_randgen;
     UniqueID m_uid;
-    double initDefaultRand() const;
   };
 }
 
@@ -86,11 +88,12 @@ inline void NCrystal::CalcBase::setCalcName(const char * n)
 
 inline NCrystal::RandomBase* NCrystal::CalcBase::getRNG() const
 {
-  if (!m_randgen.obj()) {
-    m_randgen = defaultRandomGenerator();
-    nc_assert(m_randgen.obj());
+  RandomBase * rg = m_randgen.obj();
+  if (!rg) {
+    rg = threadDefaultRandomGenerator();
+    nc_assert(rg);
   }
-  return m_randgen.obj();
+  return rg;
 }
 
 inline NCrystal::RandomBase* NCrystal::CalcBase::getRNGNoDefault() const
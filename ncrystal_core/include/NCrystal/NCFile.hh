@@ -97,6 +97,26 @@ namespace NCrystal {
                                                                                  const std::string& buffer );
   NCRYSTAL_API std::unique_ptr<TextInputStream> createTextInputStreamFromFile( const std::string& filepath );//NB: will NOT use the find_file(..) function
 
+  //Packed data archives: A single file containing any number of text files
+  //(e.g. the entire data library of an installation), which can be created
+  //with the ncrystal_packdata script. The archive file is opened once and
+  //memory-mapped (on platforms supporting it), after which all contained files
+  //are served directly from memory via an in-memory hash index, without any
+  //further filesystem access. This is mostly intended to avoid excessive load
+  //on (network) filesystems when large numbers of processes start up
+  //simultaneously, e.g. on computing clusters.
+  //
+  //Create a TextInputManager serving files from such an archive (pass it to
+  //registerTextInputManager to use it). Throws FileNotFound or DataLoadError in
+  //case of problems with the archive:
+  NCRYSTAL_API std::unique_ptr<TextInputManager> createArchiveTextInputManager( const std::string& archive_path,
+                                                                                bool allowFallbackToUsualDefaults = true );
+
+  //Alternatively, set the environment variable NCRYSTAL_DATA_ARCHIVE to the
+  //path of an archive file. In the absence of a custom TextInputManager
+  //providing the requested file, the archive will then be searched before
+  //falling back to the usual search for on-disk files with find_file(..).
+
 }
 
 #endif
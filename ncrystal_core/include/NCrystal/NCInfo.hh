@@ -74,6 +74,33 @@ namespace NCrystal {
 
   typedef std::vector<HKLInfo> HKLList;
 
+  struct NCRYSTAL_API HKLArrays final : public MoveOnly {
+    //Structure-of-arrays storage of the same information as in an HKLList,
+    //with all entries in a few contiguous buffers (same ordering as the
+    //HKLList). If normals are available, the demi_normals (and eqv_hkl, if
+    //available) of entry i are found at indices [normals_offset[i],
+    //normals_offset[i+1]) of the normal_x/y/z arrays (with eqv_hkl containing
+    //three entries per normal):
+    VectD dspacing, fsquared;
+    std::vector<int> h, k, l;
+    std::vector<unsigned> multiplicity;
+    std::vector<std::size_t> normals_offset;//size()+1 entries (empty if no normals).
+    VectD normal_x, normal_y, normal_z;
+    std::vector<short> eqv_hkl;//empty if not available.
+    std::size_t size() const { return dspacing.size(); }
+    bool hasNormals() const { return !normals_offset.empty(); }
+    bool hasEqvHKL() const { return !eqv_hkl.empty(); }
+  };
+
+  //Info objects can optionally store expanded HKL information (normals and
+  //eqv_hkl) in an HKLArrays object rather than in the individual HKLInfo
+  //entries. This improves memory locality and reduces the number of
+  //allocations for crystals with many planes. This is disabled by default,
+  //unless the NCRYSTAL_HKLARRAYS environment variable is set. The setting
+  //affects Info objects created after it is changed:
+  NCRYSTAL_API void enableHKLArrayStorage( bool );
+  NCRYSTAL_API bool hklArrayStorageEnabled();
+
   struct NCRYSTAL_API AtomIndex {
     unsigned value;
     bool operator<(const AtomIndex& o) const { return value<o.value; }
@@ -354,9 +381,29 @@ namespace NCrystal {
     //Whether HKLInfo objects have eqv_hkl available:
     bool hasExpandedHKLInfo() const;
 
-    //Search eqv_hkl lists for specific (h,k,l) value. Returns hklEnd() if not found:
+    //Search eqv_hkl lists for specific (h,k,l) value. Returns hklEnd() if not
+    //found. A hash index of all (h,k,l) values (and their negations) is built
+    //on first usage, so lookups are cheap even for large unit cells. Note that
+    //when the HKL info is kept in arrays (see hasHKLArrays() below), returning
+    //a found entry requires the HKLInfo compatibility view to be populated,
+    //just like calling hklBegin():
     HKLList::const_iterator searchExpandedHKL(short h, short k, short l) const;
 
+    //Batch version, writing the indices in the HKL list (as would be obtained
+    //by subtracting hklBegin() from the iterators returned above) of the n
+    //Miller indices in hkl (3*n entries) to out_idx, or -1 if not found. This
+    //version only needs the hash index, and never triggers population of the
+    //HKLInfo compatibility view:
+    void searchExpandedHKLIndices( std::size_t n, const int * hkl, int * out_idx ) const;
+
+    //Whether the HKL information is (also) available in the structure-of-arrays
+    //format (see enableHKLArrayStorage() above). When this is the case, the
+    //HKLInfo objects accessed via hklBegin()/hklEnd() are merely a
+    //compatibility view, which is only populated with expanded information
+    //(demi_normals and eqv_hkl) upon first usage of those methods:
+    bool hasHKLArrays() const;
+    const HKLArrays& hklArrays() const;
+
     /////////////////////
     // Density [g/cm^3] //
     /////////////////////
@@ -452,10 +499,19 @@ namespace NCrystal {
 
   private:
     void ensureNoLock();
+    void ensureHKLListExpanded() const;
+    void expandHKLList() const;
+    struct HKLIndex;
+    const HKLIndex& hklIndex() const;
+    int searchExpandedHKLIdx( int h, int k, int l ) const;
     UniqueID m_uid;
     StructureInfo m_structinfo;
     AtomList m_atomlist;
-    HKLList m_hkllist;//sorted by dspacing first
+    mutable HKLList m_hkllist;//sorted by dspacing first (mutable for lazy expansion only)
+    std::unique_ptr<const HKLArrays> m_hklarrays;
+    mutable std::once_flag m_hkllist_expandflag;
+    mutable std::unique_ptr<const HKLIndex> m_hklindex;
+    mutable std::once_flag m_hklindex_flag;
     DynamicInfoList m_dyninfolist;
     double m_hkl_dlower, m_hkl_dupper, m_density, m_numberdensity, m_xsect_free, m_xsect_absorption, m_temp, m_debyetemp;
     std::function<double(double)> m_xsectprovider;
@@ -501,16 +557,30 @@ namespace NCrystal {
   inline AtomList::const_iterator Info::atomInfoBegin() const { nc_assert(hasAtomInfo()); return m_atomlist.begin(); }
   inline AtomList::const_iterator Info::atomInfoEnd() const { nc_assert(hasAtomInfo()); return m_atomlist.end(); }
   inline bool Info::hasHKLInfo() const { return m_hkl_dupper>=m_hkl_dlower; }
-  inline bool Info::hasExpandedHKLInfo() const { return hasHKLInfo() && !m_hkllist.empty() && m_hkllist.front().eqv_hkl; }
-  inline bool Info::hasHKLDemiNormals() const { return hasHKLInfo() && !m_hkllist.empty() && ! m_hkllist.front().demi_normals.empty(); }
+  inline bool Info::hasExpandedHKLInfo() const
+  {
+    if (m_hklarrays)
+      return hasHKLInfo() && m_hklarrays->hasEqvHKL();
+    return hasHKLInfo() && !m_hkllist.empty() && m_hkllist.front().eqv_hkl;
+  }
+  inline bool Info::hasHKLDemiNormals() const
+  {
+    if (m_hklarrays)
+      return hasHKLInfo() && m_hklarrays->hasNormals();
+    return hasHKLInfo() && !m_hkllist.empty() && ! m_hkllist.front().demi_normals.empty();
+  }
+  inline bool Info::hasHKLArrays() const { return m_hklarrays != nullptr; }
+  inline const HKLArrays& Info::hklArrays() const { nc_assert_always(m_hklarrays); return *m_hklarrays; }
+  inline void Info::ensureHKLListExpanded() const { if ( m_hklarrays && m_hklarrays->hasNormals() ) expandHKLList(); }
   inline unsigned Info::nHKL() const { nc_assert(hasHKLInfo()); return m_hkllist.size(); }
-  inline HKLList::const_iterator Info::hklBegin() const { nc_assert(hasHKLInfo()); return m_hkllist.begin(); }
+  inline HKLList::const_iterator Info::hklBegin() const { nc_assert(hasHKLInfo()); ensureHKLListExpanded(); return m_hkllist.begin(); }
   inline HKLList::const_iterator Info::hklLast() const
   {
     nc_assert(hasHKLInfo());
+    ensureHKLListExpanded();
     return m_hkllist.empty() ? m_hkllist.end() : std::prev(m_hkllist.end());
   }
-  inline HKLList::const_iterator Info::hklEnd() const { nc_assert(hasHKLInfo()); return m_hkllist.end(); }
+  inline HKLList::const_iterator Info::hklEnd() const { nc_assert(hasHKLInfo()); ensureHKLListExpanded(); return m_hkllist.end(); }
   inline double Info::hklDLower() const { nc_assert(hasHKLInfo()); return m_hkl_dlower; }
   inline double Info::hklDUpper() const { nc_assert(hasHKLInfo()); return m_hkl_dupper; }
   inline bool Info::hasDensity() const { return m_density > 0.0; }
@@ -179,6 +179,43 @@ namespace NCrystal {
     //               and dirtol parameters) will result in a specialised single
     //               crystal scatter model being used.
     //
+    // perf........: [ string, fallback value is "default" ]
+    //               Overall trade-off between accuracy and speed. This
+    //               parameter does not itself enter any model, but instead
+    //               provides the fallback values of the expert parameters
+    //               vdoslux, mosprec, sccutoff and sabegridtol (values set
+    //               explicitly for those parameters always take precedence):
+    //
+    //                 perf      | vdoslux | mosprec | sccutoff | sabegridtol
+    //                 ----------+---------+---------+----------+------------
+    //                 reference |    5    |  1e-6   |   0Aa    |     0
+    //                 default   |    3    |  1e-3   |   0.4Aa  |     0
+    //                 fast      |    2    |  1e-2   |   0.4Aa  |    1e-3
+    //                 fastest   |    1    |  3e-2   |   0.5Aa  |    1e-2
+    //
+    //               The "reference" level is intended for validation only.
+    //               Initialisation takes several seconds per material (versus
+    //               0.1-0.3s for perf=default). Cross section evaluations for
+    //               single crystals are about 1.5 times slower, except for
+    //               layered crystals (lcaxis set), where each evaluation takes
+    //               several milliseconds (hundreds of times slower than with
+    //               perf=default), which is impractical for simulations. For
+    //               those, also setting mosprec=1e-4 makes evaluations 30 times
+    //               faster, with average deviations of 2e-5 (at most 0.1% at
+    //               individual points).
+    //
+    //               Total cross sections were compared to those of
+    //               perf=reference for a selection of materials, at
+    //               wavelengths in 0.5-6Aa (and directions spread over all
+    //               angles for single crystals), as done in the program
+    //               examples/ncrystal_validate_perflevels.cc.
+    //               The average absolute deviation, relative to the average
+    //               cross section, is below 0.2% for perf=default, 0.6% for
+    //               perf=fast and 1.5% for perf=fastest. For single crystals
+    //               the bounds are 0.5%, 1% and 4% respectively, mainly due to
+    //               sccutoff. Deviations at individual points can be larger,
+    //               in particular close to Bragg edges and peaks.
+    //
     //
     /////////////////////////////////////////////////////////////////////////////
     // Options mainly of interests to experts and NCrystal developers:
@@ -203,7 +240,7 @@ namespace NCrystal {
     //               directly select factory with which to create
     //               NCrystal::Absorption instances.
     //
-    // mosprec.....: [ double, fallback value is 1.0e-3 ]
+    // mosprec.....: [ double, fallback value is 1.0e-3 (but see perf) ]
     //               Approximate relative precision in implementation of mosaic
     //               model in single crystals. Affects both approximations used
     //               and truncation range of Gaussian. Values must be in the
@@ -213,14 +250,52 @@ namespace NCrystal {
     //               Choose which modelling is used for layered crystals (has no
     //               effect unless lcaxis is also set). The default value
     //               indicates the recommended model, which is both fast and
-    //               accurate. A positive value triggers a very slow but simple
-    //               reference model, in which n=lcmode crystallite orientations
-    //               are sampled internally (the model is accurate only when n
-    //               is very high). A negative value triggers a different model
-    //               in which each crossSection call triggers a new selection of
-    //               n=-lcmode randomly oriented crystallites.
-    //
-    // sccutoff....: [ double, fallback value is 0.4Aa ]
+    //               accurate. A positive value triggers a slower but simpler
+    //               reference model, in which cross-sections are found by
+    //               direct numerical integration over crystallite rotations,
+    //               while n=lcmode crystallite orientations are sampled
+    //               internally when generating scatterings (which is accurate
+    //               only when n is very high). A negative value triggers a
+    //               different model in which each crossSection call triggers a
+    //               new selection of n=-lcmode randomly oriented crystallites
+    //               (but see also lcrotseed).
+    //
+    // lcrotseed...: [ int, fallback value is -1 ]
+    //               Only has an effect when lcmode<0. If set to a non-negative
+    //               value, the n=-lcmode crystallite orientations are instead
+    //               chosen deterministically once at initialisation time from
+    //               a quasi-random (golden angle) sequence, with the value of
+    //               this parameter selecting the starting point of the
+    //               sequence. Cross-sections are then reproducible and do not
+    //               consume random numbers, but for small n they are biased
+    //               towards the particular orientations chosen rather than
+    //               being averages over random orientations.
+    //
+    // lctabprec...: [ double, fallback value is 0 ]
+    //               If non-zero, the cross-sections of layered crystals
+    //               (i.e. when lcaxis is set and lcmode=0) will be pre-tabulated
+    //               at initialisation time as a function of neutron wavelength
+    //               and angle to the lcaxis, with the value of this parameter
+    //               being the target relative precision of the interpolation
+    //               in the table. This results in much faster cross-section
+    //               evaluations in cases where each neutron arrives with a new
+    //               direction, at the cost of a significantly increased
+    //               initialisation time and memory usage, so it is mainly
+    //               useful for long-running simulations. As an example, for
+    //               pyrolytic graphite with 2.5deg mosaicity, lctabprec=3e-2
+    //               and 1e-2 takes about 20s and 40s respectively to
+    //               initialise, and the initialisation time grows quickly for
+    //               tighter precision or smaller mosaicity. The table is
+    //               limited to about 16MB per material, and if that limit is
+    //               reached before the requested precision is achieved
+    //               everywhere, a warning is printed and cross-sections in the
+    //               remaining regions are evaluated directly (i.e. as without
+    //               the table, which is also the case for small regions just
+    //               below Bragg edges). The table covers wavelengths down to
+    //               10% of the Bragg threshold of the material. Values must be
+    //               0 or in the range [1e-5,1e-1].
+    //
+    // sccutoff....: [ double, fallback value is 0.4Aa (but see perf) ]
     //               Single-crystal d-spacing cutoff in Angstrom. When creating
     //               single-crystal scatterers, crystal planes with spacing
     //               below this value will be modelled as having an isotropic
@@ -234,7 +309,7 @@ namespace NCrystal {
     //               naturally disables this approximation.
     //               [ Recognised units: "Aa", "nm", "mm", "cm", "m" ]
     //
-    // vdoslux.....: [ int, fallback value is 3 ]
+    // vdoslux.....: [ int, fallback value is 3 (but see perf) ]
     //               Setting affecting "luxury" level when expanding phonon
     //               spectrums (VDOS) into scattering kernels, affecting things
     //               like number of (alpha,beta) grid points in the resulting
@@ -263,6 +338,89 @@ namespace NCrystal {
     //               vdoslux level actually used will be 3 less than the one
     //               specified in this variable (but at least 0).
     //
+    // sabfloat....: [ int, fallback value is 0 ]
+    //               Storage precision of the tables derived from scattering
+    //               kernels (S(alpha,beta)) for sampling and cross section
+    //               evaluation. The default, 0, uses double precision. Setting
+    //               sabfloat=1 drops the table of log(S) values (they are
+    //               instead computed from S when needed) and stores the
+    //               cumulative alpha integrals in single precision. The memory
+    //               usage of these derived tables thus goes from 16 to 4 bytes
+    //               per kernel point, a reduction of about a factor of 4 (e.g.
+    //               2.25MB to 0.56MB for Al_sg225), at the cost of a small loss
+    //               of numerical precision and some extra CPU time when
+    //               sampling. The input kernel itself (SABData) is not affected
+    //               and remains in double precision. Setting sabfloat=2 is the
+    //               same as sabfloat=1, but additionally prints a report
+    //               comparing cross sections and sampled values to those
+    //               obtained with double precision storage (for validation
+    //               purposes only).
+    //
+    // sabegridtol.: [ double, fallback value is 0.0 (but see perf) ]
+    //               Relative tolerance for adaptive construction of the energy
+    //               grids on which cross sections and samplers are tabulated for
+    //               scattering kernels (S(alpha,beta)). The default, 0.0, uses
+    //               a fixed grid (by default 300 geometrically spaced points,
+    //               unless the input specifies otherwise via "egrid"). When
+    //               positive, a coarse grid is instead refined by bisection
+    //               only where linear interpolation of the cross section
+    //               deviates by more than this relative amount, never using
+    //               more points than the fixed grid would. This typically
+    //               reduces initialisation time and memory usage for smooth
+    //               kernels. Has no effect when the input provides a complete
+    //               energy grid. Must be 0 or lie in (0,0.1].
+    //
+    // sabalphatab.: [ int, fallback value is 0 ]
+    //               If non-zero, alpha values are sampled from scattering
+    //               kernels (S(alpha,beta)) by direct inversion of inverse-CDF
+    //               tables with this number of points, precomputed for each
+    //               relevant beta column at each point of the energy grid. This
+    //               gives a flat and predictable cost per scattering, at the
+    //               cost of additional memory usage and an approximation
+    //               (linear interpolation between tabulated percentiles),
+    //               which biases the sampled distributions for coarse tables.
+    //               Values of 256 or more are recommended. The default, 0,
+    //               samples alpha directly from the kernel. Must be 0 or an
+    //               integer from 128 to 16384.
+    //
+    // sabtempinterp: [ double, fallback value is 0.0 ]
+    //               If non-zero, scattering kernels (S(alpha,beta)) expanded
+    //               from a VDOS are not built directly at the temperature of
+    //               the material, but are instead interpolated between kernels
+    //               built at fixed anchor temperatures (8 per doubling of the
+    //               temperature, i.e. spaced by about 9%). The interpolation
+    //               is linear in log(S) versus 1/T at fixed momentum and
+    //               energy transfer, which preserves detailed balance. Each
+    //               interpolated kernel needs two bracketing anchor kernels
+    //               plus a third for an error estimate, i.e. up to three
+    //               kernel expansions instead of one. This is always done,
+    //               also when only a single temperature is needed, so that
+    //               results depend only on the configuration. Consequently,
+    //               loading a single temperature costs two to three times as
+    //               much as without sabtempinterp, and it only pays off when
+    //               the same material is loaded at several temperatures. The
+    //               16 most recently used anchor kernels are kept in memory
+    //               until clearCaches() is called, so further temperatures in
+    //               the same range then only cost the interpolation itself
+    //               (plus a direct build if the error estimate is exceeded,
+    //               see below). Note that only the kernel
+    //               expansion is saved: the tables derived from the kernel for
+    //               cross section evaluation and sampling are still built for
+    //               each temperature. The value specifies the tolerance on the
+    //               estimated relative error of the interpolated kernel,
+    //               integrated over the (alpha,beta) grid (obtained by
+    //               comparing with a quadratic interpolation involving a
+    //               third anchor). If the estimate exceeds this tolerance, the
+    //               kernel is built directly at the requested temperature
+    //               instead. The tolerance is not a bound on the errors of
+    //               derived quantities: with sabtempinterp=1e-3, inelastic
+    //               cross sections were seen to deviate by 0.1-0.7% from those
+    //               of directly built kernels. The error estimate is printed if
+    //               the NCRYSTAL_DEBUG_PHONON environment variable is set. Has no
+    //               effect on kernels provided directly in the input or
+    //               derived from Debye temperatures. Must be 0 or lie in
+    //               (0,0.1].
+    //
     // atomdb......: [ string, fallback value is "" ]
     //               Modify atomic definitions if supported by the info factory
     //               (in practice this is unlikely to be supported by anything
@@ -322,7 +480,14 @@ namespace NCrystal {
     void set_scatfactory( const std::string& );
     void set_absnfactory( const std::string& );
     void set_lcmode( int );
+    void set_lcrotseed( int );
+    void set_lctabprec( double );
     void set_vdoslux( int );
+    void set_sabfloat( int );
+    void set_sabegridtol( double );
+    void set_sabtempinterp( double );
+    void set_sabalphatab( int );
+    void set_perf( const std::string& );
     void set_atomdb( const std::string& );
     //
     //Special setter method, which will set all orientation parameters based on
@@ -365,7 +530,14 @@ namespace NCrystal {
     const std::string& get_scatfactory() const;
     const std::string& get_absnfactory() const;
     int  get_lcmode() const;
+    int  get_lcrotseed() const;
+    double get_lctabprec() const;
     int  get_vdoslux() const;
+    int  get_sabfloat() const;
+    double get_sabegridtol() const;
+    double get_sabtempinterp() const;
+    int  get_sabalphatab() const;
+    const std::string& get_perf() const;
     const std::string& get_atomdb() const;
     const std::vector<VectS>& get_atomdb_parsed() const;
 
@@ -27,16 +27,39 @@ namespace NCrystal {
 
   //Set the default random generator which all CalcBase classes will use
   //for random number generation (unless overridden explicitly with
-  //setRandomGenerator on the instance):
+  //setRandomGenerator on the instance, or per thread with
+  //setThreadDefaultRandomGenerator below):
 
   NCRYSTAL_API void setDefaultRandomGenerator(RandomBase*);
 
   //Returns the global default random generator. If setDefaultRandomGenerator
   //was never called, this will trigger the creation of a RandXRSR generator
-  //(see below) as the default unless trigger_default=false:
+  //(see below) as the default unless trigger_default=false. The returned
+  //pointer is only guaranteed to stay valid until the default is replaced:
 
   NCRYSTAL_API RandomBase * defaultRandomGenerator(bool trigger_default = true);
 
+  //Bind a default random generator for the calling thread only, which in that
+  //thread takes precedence over the global default set with
+  //setDefaultRandomGenerator (a null pointer removes the binding again). This
+  //allows threads to draw from their own random streams, even when they use
+  //CalcBase instances without an explicitly set generator. Note that this does
+  //not in itself make it safe to share CalcBase instances between threads,
+  //since some of them (e.g. SCBragg and LCBragg) use unsynchronised internal
+  //caches. The binding keeps a reference to the generator until it is changed
+  //or the thread exits:
+
+  NCRYSTAL_API void setThreadDefaultRandomGenerator(RandomBase*);
+
+  //Returns the generator used in the calling thread by CalcBase instances
+  //without an explicitly set generator: the one bound to the thread if any,
+  //otherwise the global default (with trigger_default as above). Each thread
+  //keeps a reference to the global default it last used, so replacing the
+  //default while other threads are using it is safe (but note that a single
+  //global default generator used by several threads concurrently is not):
+
+  NCRYSTAL_API RandomBase * threadDefaultRandomGenerator(bool trigger_default = true);
+
   //Generator implementing the xoroshiro128+ (XOR/rotate/shift/rotate) due to
   //David Blackman and Sebastiano Vigna (released into public domain / CC0
   //1.0). It has a period of 2^128-1, is very fast and passes most statistical
@@ -39,8 +39,14 @@ namespace NCrystal {
   //behind the scene in order to prevent duplication of work in case of repeated
   //calls. The cache can obviously be cleared with the
   //clearSABDataFromDynInfoCaches function (automatically invoked by the global
-  //clearCaches function):
-  std::shared_ptr<const SABData> extractSABDataFromDynInfo( const DI_ScatKnl*, unsigned vdoslux = 3, bool useCache = true );
+  //clearCaches function).
+  //
+  //A non-zero tempinterp value enables interpolation of VDOS-based kernels
+  //between kernels at fixed anchor temperatures, with tempinterp being the
+  //tolerance on the estimated relative error (see the sabtempinterp parameter
+  //in NCMatCfg.hh):
+  std::shared_ptr<const SABData> extractSABDataFromDynInfo( const DI_ScatKnl*, unsigned vdoslux = 3, bool useCache = true,
+                                                            double tempinterp = 0.0 );
   std::shared_ptr<const SABData> extractSABDataFromVDOSDebyeModel( double debyeTemperature,
                                                                    double temperature, SigmaBound boundXS, double elementMassAMU,
                                                                    unsigned vdoslux = 3, bool useCache = true );
@@ -22,6 +22,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "NCrystal/NCDefs.hh"
+#include "NCrystal/internal/NCSpan.hh"
 
 namespace NCrystal {
 
@@ -59,12 +60,18 @@ namespace NCrystal {
     ~ElIncXS();
 
     //Empty if no elements added (evaluate() will always return zero).
-    bool empty() const { return m_elm_data.empty(); }
+    bool empty() const { return m_msd.empty(); }
 
     //Evaluate the incoherent elastic cross section:
     static double evaluateMonoAtomic(double ekin, double meanSqDisp, double bound_incoh_xs);
     double evaluate(double ekin) const;
 
+    //Batch evaluation, setting out[i]=evaluate(ekin[i]) (up to numerical
+    //differences of order 1e-12 relative). Energies are processed in blocks,
+    //looping over elements for each block, so only the loops over energies are
+    //candidates for auto-vectorisation:
+    void evaluate( span<const double> ekin, span<double> out ) const;
+
     //Sample cosine of scatter angle:
     static double sampleMuMonoAtomic( RandomBase *, double ekin, double meanSqDisp );
     double sampleMu( RandomBase *, double ekin );
@@ -107,9 +114,23 @@ namespace NCrystal {
     ////////////////////////////////////////////////////////////////////////////////////
 
   private:
-    std::vector<PairDD > m_elm_data;//for exact eval, (msd,boundincohxs*scale)
+    //Element data (kept as separate arrays for vectorised evaluation):
+    VectD m_msd;//mean-squared-displacements
+    VectD m_xsscaled;//boundincohxs*scale
     static double eval_1mexpmtdivt(double t);//safe/fast eval of (1-exp(-t))/t for t>=0.0 with >10 sign. digits
 
+    //Table of cumulative probabilities for selecting elements in sampleMu,
+    //tabulated on an energy grid with m_seltab_nsub points per factor of two
+    //(points uniformly spaced in each [2^(n-1),2^n] interval), starting at
+    //2^(m_seltab_exp0-1). Each grid point has nelem-1 entries (the last being
+    //implicitly 1). Energies outside the grid use exact evaluation:
+    VectD m_seltab;
+    int m_seltab_exp0 = 0;
+    int m_seltab_nexp = 0;
+    static constexpr unsigned m_seltab_nsub = 32;
+    void initSelectionTable();
+    std::size_t selectElementExact( RandomBase *, double ekin ) const;
+
   };
 }
 
@@ -41,6 +41,8 @@
 
 namespace NCrystal {
 
+  struct EqReflOp;
+
   class EqRefl
   {
   public:
@@ -49,6 +51,7 @@ namespace NCrystal {
     ~EqRefl();
 
     struct HKL {
+      HKL() : h(0), k(0), l(0) {}
       HKL(int hh, int kk, int ll) : h(hh), k(kk), l(ll) {}
       int h;
       int k;
@@ -56,34 +59,48 @@ namespace NCrystal {
       bool operator<(const HKL&o) const {
         return ( h!=o.h ? h<o.h : ( k!=o.k ? k<o.k : l<o.l ) );
       }
+      bool operator==(const HKL&o) const { return h==o.h && k==o.k && l==o.l; }
     };
 
-    const std::set<HKL>& getEquivalentReflections(int h, int k, int l);
+    //Fixed-capacity, sorted and duplicate-free list of equivalent reflections.
+    //Only one of each (h,k,l) and (-h,-k,-l) pair (the largest) is included,
+    //i.e. a point group has at most 48 operations (including inversion), we
+    //need at most 24 entries:
+    class HKLSet {
+    public:
+      static constexpr unsigned capacity = 24;
+      const HKL* begin() const { return m_data; }
+      const HKL* end() const { return m_data + m_n; }
+      std::size_t size() const { return m_n; }
+      bool empty() const { return m_n == 0; }
+      const HKL& operator[](std::size_t i) const { nc_assert(i<m_n); return m_data[i]; }
+      void clear() { m_n = 0; }
+      void insertDemi( int h, int k, int l );//inserts max((h,k,l),(-h,-k,-l)) if not present.
+    private:
+      HKL m_data[capacity];
+      unsigned m_n = 0;
+    };
 
-  private:
-    void calc_Triclinic_1_2(int,int,int);
-    void calc_Monoclinic_3_15(int,int,int);
-    void calc_Orthorhombic_16_74(int,int,int);
-    void calc_Tetragonal_75_88(int,int,int);
-    void calc_Tetragonal_89_142(int,int,int);
-    void calc_Trigonal_143_148(int,int,int);
-    void calc_Trigonal_149_167(int,int,int);
-    void calc_Hexagonal_168_176(int,int,int);
-    void calc_Hexagonal_177_194(int,int,int);
-    void calc_Cubic_195_206(int,int,int);
-    void calc_Cubic_207_230(int,int,int);
-
-    void add(int h,int k,int l) {
-      HKL a(h,k,l);
-      HKL am(-h,-k,-l);
-      //only insert one deminormal, not both am and a:
-      if (!m_planes.count(a)&&!m_planes.count(am))
-        m_planes.insert(am<a?a:am);
-    }
-
-    std::set<HKL> m_planes;
-    void (EqRefl::*m_calc) (int,int,int);
+    //Get equivalent reflections (the returned reference stays valid until the
+    //next call):
+    const HKLSet& getEquivalentReflections(int h, int k, int l);
 
+    //Same, but filling a caller-provided buffer:
+    void getEquivalentReflections(int h, int k, int l, HKLSet& out) const;
+
+    //Batch version, expanding n reflections given as (h,k,l) triplets in
+    //hkl_in. The equivalent reflections are appended as (h,k,l) triplets to
+    //out_hkl, and out_offsets gets n+1 entries appended (starting with the
+    //current triplet count in out_hkl), such that the reflections equivalent
+    //to input i are the triplets in [out_offsets[i],out_offsets[i+1]):
+    void getEquivalentReflections( const int * hkl_in, std::size_t n,
+                                   std::vector<int>& out_hkl,
+                                   std::vector<std::size_t>& out_offsets ) const;
+
+  private:
+    const EqReflOp * m_ops;//point group operations (first is identity)
+    unsigned m_nops;
+    HKLSet m_planes;
   };
 
 
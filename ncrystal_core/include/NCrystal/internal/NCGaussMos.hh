@@ -102,6 +102,34 @@ namespace NCrystal {
                               std::vector<ScatCache>& cache,
                               VectD& xs_commul ) const;
 
+    //Same, but with the demi-normals stored as separate arrays of x, y and z
+    //coordinates. This allows the truncation test (which rejects the vast
+    //majority of demi-normals) to be carried out for blocks of demi-normals at
+    //a time, in a manner which is amenable to auto-vectorisation by the
+    //compiler. Results are identical to those of the method above:
+    class DemiNormals;
+    double calcCrossSections( InteractionPars& ip,
+                              const Vector& neutron_indir,
+                              const DemiNormals& deminormals,
+                              std::vector<ScatCache>& cache,
+                              VectD& xs_commul ) const;
+
+    class DemiNormals {
+    public:
+      DemiNormals(){}
+      void reserve(std::size_t n);
+      void push_back(const Vector&);
+      std::size_t size() const { return m_x.size(); }
+      bool empty() const { return m_x.empty(); }
+      Vector at(std::size_t i) const { nc_assert(i<size()); return Vector(m_x[i],m_y[i],m_z[i]); }
+      std::vector<Vector> toVector() const;
+      const double * xData() const { return &m_x[0]; }
+      const double * yData() const { return &m_y[0]; }
+      const double * zData() const { return &m_z[0]; }
+    private:
+      VectD m_x, m_y, m_z;
+    };
+
     //Scatterings can only be generated once appropriate info has been found via
     //previous calls to cross-section methods, and with relevant info embedded
     //into ScatCache objects (of course, they will only be relevant for the
@@ -137,6 +165,10 @@ namespace NCrystal {
     double m_prec;
     void updateDerivedValues();
     double calcRawCrossSectionValueInit( InteractionPars&, double ) const;
+    void addContributions( InteractionPars&, const Vector& normal, double dot,
+                           double sdotcptsq, double ds, double cta,
+                           std::vector<ScatCache>&, VectD& xs_commul,
+                           double xsoffset, double& xssum ) const;
   };
 
   class GaussMos::InteractionPars {
@@ -193,6 +225,9 @@ namespace NCrystal {
     return m_wl>0;
   }
 
+  inline void GaussMos::DemiNormals::reserve(std::size_t n) { m_x.reserve(n); m_y.reserve(n); m_z.reserve(n); }
+  inline void GaussMos::DemiNormals::push_back(const Vector& v) { m_x.push_back(v.x()); m_y.push_back(v.y()); m_z.push_back(v.z()); }
+
   inline GaussMos::ScatCache::ScatCache(): m_plane_inv2d(0) {}
   inline GaussMos::ScatCache::ScatCache(const Vector& pn, double i2d) : m_plane_normal(pn), m_plane_inv2d(i2d) { nc_assert(i2d>0&&pn.isUnitVector()); }
   inline void GaussMos::ScatCache::set(const Vector& pn, double i2d) { nc_assert(i2d>0&&pn.isUnitVector()); m_plane_normal = pn; m_plane_inv2d = i2d; }
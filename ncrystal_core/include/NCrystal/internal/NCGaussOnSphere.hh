@@ -55,7 +55,8 @@ namespace NCrystal {
     //to avoid expensive calls (this time replacing exp+acos+sqrt+erf calls),
     //and the former uses the CosSinGridGen to avoid expensive cosine
     //calls. Sampling points on circles is implemented precisely as rejection
-    //sampling.
+    //sampling, using a Gaussian overlay function which for most parameters
+    //results in acceptance rates close to unity.
     //
     //The precision parameter is used to control the rough precision of the
     //approximations used: When and how to carry out full numerical integration
@@ -135,6 +136,7 @@ namespace NCrystal {
     double m_truncangle;
     double m_sigma;
     double m_numint_accuracy;
+    double m_gaussoverlay_safety;//bound on rounding errors in genPointOnCircle
     SplinedLookupTable m_lt_sofcosd;
     SplinedLookupTable m_lt_evalcosx;
     double m_prec;//for reference
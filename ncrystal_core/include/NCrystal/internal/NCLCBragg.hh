@@ -40,9 +40,20 @@ namespace NCrystal {
     //
     //     mode=0: LCHelper
     //     mode>0: LCBraggRef(nsample=mode)
-    //     mode<0: LCBraggRndmRef(nsample=-mode)
+    //     mode<0: LCBraggRndmRot(nsample=-mode), or if fixedrot_seed>=0,
+    //             LCBraggFixedRot(nsample=-mode,seed=fixedrot_seed)
     //
     //For a description of the prec and ntrunc parameters, see NCGaussMos.hh.
+    //
+    //If mode=0 and xstab_prec>0, cross-sections will be pre-tabulated at
+    //construction time as a function of wavelength and angle to the lcaxis
+    //(see LCXSTable in NCLCUtils.hh), with xstab_prec being the target
+    //relative precision of the interpolation. This trades initialisation time
+    //and memory for very fast crossSection calls without any internal caches.
+    //Regions which the table does not cover (short wavelengths, regions just
+    //below Bragg edges, or regions left out when the table reached its
+    //maximum size, in which case a warning is printed) are still evaluated
+    //directly.
     LCBragg( const Info*,
              const SCOrientation&,
              double mosaicity,
@@ -51,7 +62,9 @@ namespace NCrystal {
              double delta_d = 0,
              PlaneProvider * plane_provider = 0,
              double prec=1e-3,
-             double ntrunc=0.0 );
+             double ntrunc=0.0,
+             double xstab_prec=0.0,
+             int fixedrot_seed=-1 );
 
     //The cross-section (in barns):
     virtual double crossSection( double ekin, const double (&neutron_direction)[3] ) const;
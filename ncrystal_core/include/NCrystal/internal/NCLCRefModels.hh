@@ -29,10 +29,19 @@ namespace NCrystal {
 
   class LCBraggRef : public Scatter {
   public:
-    //Simple but very slow implementation of layered crystals. Mainly provided
-    //as a reference (should give increasingly better result with higher
-    //nsample).
-    LCBraggRef(Scatter* scbragg, Vector lcaxis_lab, unsigned nsample = 1000);
+    //Simple but slow implementation of layered crystals. Mainly provided as a
+    //reference (should give increasingly better result with higher nsample).
+    //
+    //If scbragg is an SCBragg instance and phi_analytic is true, cross-sections
+    //are found by integrating the contribution of each demi-normal over the
+    //rotation angle around the lcaxis numerically (within the narrow windows
+    //of rotation angles where the Gaussian mosaicity distribution is
+    //non-vanishing), rather than by averaging over nsample discrete rotations
+    //of scbragg. The nsample parameter is then only used in
+    //generateScattering, and for the reflection families of any crossSection
+    //call where the integration fails to converge (in which case a warning is
+    //emitted once, and the rotation average is used for those families).
+    LCBraggRef(Scatter* scbragg, Vector lcaxis_lab, unsigned nsample = 1000, bool phi_analytic = true);
     virtual ~LCBraggRef();
     virtual void domain(double& ekin_low, double& ekin_high) const;
     virtual double crossSection( double ekin, const double (&indirraw)[3] ) const;
@@ -45,6 +54,8 @@ namespace NCrystal {
     Vector m_lcaxislab;
     unsigned m_nsample;
     unsigned m_nsampleprime;
+    struct PhiIntegrator;
+    std::unique_ptr<const PhiIntegrator> m_phiint;
   };
 
   class LCBraggRndmRot : public Scatter {
@@ -71,6 +82,31 @@ namespace NCrystal {
     } cache;
   };
 
+  class LCBraggFixedRot : public Scatter {
+  public:
+    //Deterministic variant of LCBraggRndmRot, using a fixed set of nsample
+    //crystallite rotations around the lcaxis, chosen quasi-randomly (golden
+    //angle sequence) at construction time. Different seed values select
+    //different (but still deterministic) sets. Since the rotations are fixed,
+    //crossSection does not consume random numbers and gives reproducible
+    //results, while only generateScattering uses the RNG. Note that for small
+    //nsample, results are biased towards the particular rotations chosen rather
+    //than being an average over random rotations. Again, this is mainly
+    //provided as a reference and not really recommended for general usage.
+    LCBraggFixedRot(Scatter* scbragg, Vector lcaxis_lab, unsigned nsample, unsigned seed = 0);
+    virtual ~LCBraggFixedRot();
+    virtual void domain(double& ekin_low, double& ekin_high) const;
+    virtual double crossSection( double ekin, const double (&indirraw)[3] ) const;
+    virtual void generateScattering( double ekin,
+                                     const double (&indirraw)[3],
+                                     double (&outdir)[3],
+                                     double& delta_ekin ) const;
+  private:
+    RCHolder<const Scatter> m_sc;
+    Vector m_lcaxislab;
+    std::vector<PhiRot> m_rotations;
+  };
+
 }
 
 #endif
@@ -182,10 +182,13 @@ namespace NCrystal {
     class Cache;
     bool isValid(Cache&, double wavelength, double c3 ) const;
     bool isValid(Cache&, double wavelength, const Vector& indir) const;
+    void ensureValid(Cache&, double wavelength, double c3 ) const;
     void ensureValid(Cache&, double wavelength, const Vector& indir) const;
 
     //Valid caches can be used to get cross-sections or generate scatterings:
     double crossSection( Cache&, double wavelength, const Vector& indir ) const;
+    //Cross-sections only depend on the wavelength and c3=dot(indir,lcaxis_labframe):
+    double crossSection( Cache&, double wavelength, double c3 ) const;
     void genScatter( Cache&, RandomBase*, double wavelength, const Vector& indir, Vector& outdir ) const;
 
     //Access without cache.
@@ -200,7 +203,9 @@ namespace NCrystal {
     LCHelper(const LCHelper&) = delete;
     void operator=(const LCHelper&) = delete;
 
-    const GaussMos& gaussMos() { return m_lcstdframe.gaussMos(); }
+    const GaussMos& gaussMos() const { return m_lcstdframe.gaussMos(); }
+    const Vector& lcaxisLab() const { return m_lcaxislab; }
+    const std::vector<LCPlaneSet>& planeSets() const { return m_planes; }//sorted by dspacing, largest first.
 
   private:
     friend class Cache;
@@ -241,6 +246,74 @@ namespace NCrystal {
       std::vector<Overlay> m_roi_overlays;//for selecting
     };
   };
+
+  class LCXSTable {
+    //Pre-tabulated cross-sections of an LCHelper object. Since the
+    //cross-sections only depend on (wavelength,|c3|), they can be tabulated
+    //once at initialisation time, after which lookups are simple
+    //interpolations without any mutable state (and thus safe for concurrent
+    //usage).
+    //
+    //The (wavelength,angle-to-lcaxis) plane is first divided into base cells,
+    //with sizes given by the mosaicity and with Bragg edges always falling on
+    //cell boundaries (cross-sections are discontinuous there). Each cell holds
+    //a 5x5 lattice of exact values, and is accepted when bilinear
+    //interpolation on the coarser 3x3 sub-lattice reproduces all the other
+    //lattice values within the requested relative precision (values stored
+    //are thus typically 4 times more precise). Otherwise the cell is bisected
+    //in wavelength or angle, and the two halves examined in turn.
+    //
+    //Regions which can not be tabulated in this manner are instead marked as
+    //untabulated, and cross-sections there must be found by direct usage of
+    //the LCHelper. This happens for cells which reach the minimum cell size
+    //without converging, for the narrow regions just below Bragg edges where
+    //the edge planes are near backscattering (the cross-sections there have
+    //structure on all scales), and for all remaining unconverged cells if the
+    //number of stored values would exceed maxpoints (in which case
+    //reachedMaxPoints() will return true).
+    //
+    //The table covers wavelengths from wlmin up to the Bragg threshold of the
+    //LCHelper, and cross-sections for wavelengths below wlmin must likewise be
+    //found by direct usage of the LCHelper. Note that initialisation time is
+    //dominated by the exact evaluations, of which there are roughly as many
+    //as stored values (e.g. one million for pyrolytic graphite with 2.5deg
+    //mosaicity and prec=3e-2, taking about 20s), and grows quickly with tighter
+    //precision or smaller mosaicities.
+  public:
+    LCXSTable( const LCHelper&, double prec, double wlmin, std::size_t maxpoints = 4000000 );
+    ~LCXSTable();
+
+    bool coversWavelength( double wavelength ) const;
+
+    //Look up cross-section. Returns false (leaving xs untouched) if the point
+    //is not covered by the table, in which case the cross-section must be
+    //evaluated directly with the LCHelper:
+    bool lookup( double wavelength, const Vector& indir, double& xs ) const;
+    bool lookup( double wavelength, double c3, double& xs ) const;
+
+    //Information about the resulting table:
+    std::size_t nCells() const { return m_nodes.size(); }
+    std::size_t nValues() const { return m_vals.size(); }
+    std::size_t nUntabulatedCells() const { return m_nuntabulated; }
+    bool reachedMaxPoints() const { return m_capped; }
+
+  private:
+    //Cells are kept in a forest of binary trees (one per base cell, with the
+    //roots first in m_nodes). Children of split cells are found at
+    //m_nodes[index] and m_nodes[index+1], and tabulated cells have their
+    //lattice values at m_vals[index..index+24]:
+    enum NodeType : unsigned char { SplitWL, SplitTheta, Tabulated, Untabulated };
+    struct Node { uint32_t index; NodeType type; };
+    Vector m_lcaxislab;
+    VectD m_colwl;//base cell boundaries in wavelength (ascending)
+    unsigned m_nth;//number of base cells in angle
+    double m_thmax;
+    double m_dth;
+    std::vector<Node> m_nodes;
+    std::vector<float> m_vals;
+    std::size_t m_nuntabulated;
+    bool m_capped;
+  };
 }
 
 
@@ -289,6 +362,13 @@ namespace NCrystal {
   }
   inline LCHelper::Cache::~Cache(){}
 
+  inline bool LCXSTable::coversWavelength( double wl ) const { return wl >= m_colwl.front(); }
+  inline bool LCXSTable::lookup( double wl, const Vector& indir, double& xs ) const
+  {
+    nc_assert(indir.isUnitVector());
+    return lookup( wl, m_lcaxislab.dot(indir), xs );
+  }
+
   inline LCHelper::Overlay::Overlay() : data(0) {}
   inline LCHelper::Overlay::~Overlay() { delete[] data; }
   inline void LCHelper::Overlay::clear() { delete[] data; data = 0; }
@@ -93,6 +93,14 @@ namespace NCrystal {
   double atan_approx(double x);//calling atan_smallarg_approx when |x|<0.442 and falling back to std::atan and exact results otherwise.
   double expm1_smallarg_approx(double x);//7th order Taylor expansion
 
+  //Batch versions of exp_negarg_approx and exp_approx, setting out[i] to the
+  //function value at x[i]. Results are bitwise identical to those of the
+  //scalar versions, but the loops are written so the compiler can vectorise
+  //them. The out span must have the same size as x, and may be identical to it
+  //(but must otherwise not overlap it):
+  void exp_negarg_approx(span<const double> x, span<double> out);
+  void exp_approx(span<const double> x, span<double> out);
+
   //Evaluate erfc(a)-erfc(b) in a relatively numerically safe
   //manner and with as few actual calls to std::erfc as possible:
   double erfcdiff(double a, double b);
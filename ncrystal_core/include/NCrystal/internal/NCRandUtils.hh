@@ -31,12 +31,12 @@ namespace NCrystal {
   void randIsotropicDirection( RandomBase *, double (&)[3]);//result will be unit vector
   void randDirectionGivenScatterMu( RandomBase *, double mu/*=cos(scatangle)*/, const double(&in)[3], double(&out)[3]);//outdir will be unit vector
   void randPointOnUnitCircle( RandomBase *,  double & x, double& y );//Sample a random point on the unit circle
-  double randNorm( RandomBase * );//sample single value from unit Gaussian
+  double randNorm( RandomBase * );//sample single value from unit Gaussian (ziggurat method)
   void randNorm( RandomBase *, double&g1, double&g2);//sample two independent values from unit Gaussian.
   double randNormTail(double tail, RandomBase& rng);//sample gaussian tail (tail>=0!), like sampling randNorm until result is >=tail (but more efficient).
   std::size_t pickRandIdxByWeight( RandomBase *, const VectD& commulvals);//pick index according to weights (values must be commulative)
 
-  double randExp( RandomBase& rng );//sample single positive value from exp(-x)
+  double randExp( RandomBase& rng );//sample single positive value from exp(-x) (ziggurat method)
   double randExpInterval( RandomBase& rng, double a, double b, double c );//Samples value in [a,b] from exp(-c*x)
 
   class RandExpIntervalSampler {
@@ -81,11 +81,6 @@ inline double NCrystal::randIsotropicScatterMu( NCrystal::RandomBase * rand )
   return mu;
 }
 
-inline double NCrystal::randExp( NCrystal::RandomBase& rng )
-{
-  return - std::log(rng.generate());
-}
-
 inline NCrystal::RandExpIntervalSampler::RandExpIntervalSampler() : m_a(0), m_c1(0), m_c2(0)
 {
 }
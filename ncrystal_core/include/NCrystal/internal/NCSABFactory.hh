@@ -28,14 +28,21 @@ namespace NCrystal {
 
   namespace SAB {
 
-    //Direct factory function with no caching:
+    //Direct factory function with no caching (see NCSABIntegrator.hh for the
+    //meaning of the sabfloat, egridtol and nalphatab parameters):
     std::unique_ptr<const SABScatterHelper> createScatterHelper( std::shared_ptr<const SABData>,
-                                                                 std::shared_ptr<const VectD> energyGrid = nullptr );
+                                                                 std::shared_ptr<const VectD> energyGrid = nullptr,
+                                                                 unsigned sabfloat = 0,
+                                                                 double egridtol = 0.0,
+                                                                 unsigned nalphatab = 0 );
 
     //Same with caching:
     void clearScatterHelperCache();
     std::shared_ptr<const SABScatterHelper> createScatterHelperWithCache( std::shared_ptr<const SABData>,
-                                                                          std::shared_ptr<const VectD> energyGrid = nullptr );
+                                                                          std::shared_ptr<const VectD> energyGrid = nullptr,
+                                                                          unsigned sabfloat = 0,
+                                                                          double egridtol = 0.0,
+                                                                          unsigned nalphatab = 0 );
 
     //For caching reasons, we keep a database of energy grid's and an associated
     //unique id. Note that it is expected that most energy grids specified will
@@ -44,6 +51,19 @@ namespace NCrystal {
     UniqueIDValue egridToUniqueID(const VectD& egrid);
     UniqueIDValue egridToUniqueID(const std::shared_ptr<const VectD>& egrid);
     std::shared_ptr<const VectD> egridFromUniqueID(UniqueIDValue);
+
+    //Global intern table of SABData objects, keyed by a hash of their content
+    //(grids, S values, temperature, bound cross section, mass and suggested
+    //Emax). If an object with identical content was interned previously and
+    //is still alive, that object is returned. Otherwise the passed object is
+    //registered and returned. Since caches further downstream (like the one in
+    //createScatterHelperWithCache) are keyed on the unique id of the SABData,
+    //this ensures that identical kernels (and the expensive objects derived
+    //from them) are shared, no matter how they were reached. The table only
+    //holds weak references, and does not by itself keep any SABData alive
+    //(expired entries are pruned when new entries are added, and the table is
+    //emptied by the global clearCaches function):
+    std::shared_ptr<const SABData> internSABData( std::shared_ptr<const SABData> );
   }
 
 }
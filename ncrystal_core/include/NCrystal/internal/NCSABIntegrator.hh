@@ -41,6 +41,24 @@ namespace NCrystal {
       //
       //If a SABExtender is not provided, a default single-target free gas
       //extender will be used.
+      //
+      //The sabfloat parameter selects the storage type of the large tables
+      //derived from the kernel, with values having the same meaning as for the
+      //MatCfg parameter of the same name: 0 for double precision, 1 for single
+      //precision, and 2 for single precision along with a printed report of
+      //the resulting deviations in cross sections and sampled values (with
+      //respect to results obtained with double precision storage).
+      //
+      //If egridtol is positive and a complete energy grid was not provided,
+      //the energy grid will be constructed adaptively: starting from a coarse
+      //grid, intervals are bisected where linear interpolation of the cross
+      //section has a relative error larger than egridtol. The number of points
+      //will never exceed the number which would have been used for a fixed
+      //grid.
+      //
+      //If nalphatab is non-zero, the created samplers will use precomputed
+      //inverse-CDF tables with nalphatab points for sampling alpha (see
+      //NCSABSamplerModels.hh).
 
       //Both constructors and destructors of the SABIntegrator are light-weight,
       //and it is safe and recommended to end the life of SABIntegrator after
@@ -52,7 +70,10 @@ namespace NCrystal {
       ~SABIntegrator();
       SABIntegrator( std::shared_ptr<const SABData> data,
                      const VectD* egrid = nullptr,
-                     std::shared_ptr<const SABExtender> sabextender = nullptr );
+                     std::shared_ptr<const SABExtender> sabextender = nullptr,
+                     unsigned sabfloat = 0,
+                     double egridtol = 0.0,
+                     unsigned nalphatab = 0 );
 
       SABXSProvider createXSProvider() { SABXSProvider o; doit(&o,nullptr); return o; }
       SABSampler createSampler() { SABSampler o; doit(nullptr,&o); return o; }
@@ -28,33 +28,50 @@
 namespace NCrystal {
   namespace SAB {
 
+    struct SABAlphaSampleInfo  {
+      //Class able to sample alpha for a given energy and beta-value.
+      struct SAPoint {
+        double alpha = 0, sval = 0, logsval = 0;
+        unsigned alpha_idx = 0;//the grid idx by which the front/back tail is bounded.
+      };
+      SAPoint pt_front, pt_back;
+      double prob_front = 0;//1.0 means narrow, 2.0 means 0 cross-section at value, sample linearly in [pt_front.alpha,pt_back.alpha]
+      double prob_notback = 0;//prob_front+prob_middle
+    };
+
+    template<class TStorage>
     class SABSamplerAtE_Alg1 : public SABSamplerAtE {
       //A sampler which implements Algorithm1 of the Algorithm 1. of the
       //sampling paper (https://doi.org/10.1016/j.jcp.2018.11.043).
+      //
+      //The TStorage parameter (double or float) indicates the storage type of
+      //the large tables derived from the S(alpha,beta) kernel.
+      //
+      //If nalphatab>0, the inverse CDF of alpha is tabulated at nalphatab
+      //equidistant percentiles in each beta column upon construction, and
+      //alpha is subsequently sampled by simple linear interpolation in these
+      //tables. This costs memory (nalphatab values of TStorage per beta
+      //column), but gives a flat and predictable cost per sampled alpha
+      //value.
     public:
       PairDD sampleAlphaBeta(double ekin_div_kT, RandomBase&) const final;
 
       struct CommonCache {
+        //Tables derived from the kernel. With float storage, the logsab table
+        //is left empty and log(S) values are instead calculated when needed,
+        //since float precision is not sufficient for the loglin interpolations
+        //between nearby S values:
         const std::shared_ptr<const SABData> data;
-        const VectD logsab, alphaintegrals_cumul;
-      };
-      class AlphaSampleInfo  {
-        //Class able to sample alpha for a given energy and beta-value.
-      public:
-        struct SAPoint {
-          double alpha = 0, sval = 0, logsval = 0;
-          unsigned alpha_idx = 0;//the grid idx by which the front/back tail is bounded.
-        };
-        SAPoint pt_front, pt_back;
-        double prob_front = 0;//1.0 means narrow, 2.0 means 0 cross-section at value, sample linearly in [pt_front.alpha,pt_back.alpha]
-        double prob_notback = 0;//prob_front+prob_middle
+        const std::vector<TStorage> logsab, alphaintegrals_cumul;
       };
+      typedef SABAlphaSampleInfo AlphaSampleInfo;
 
       SABSamplerAtE_Alg1( std::shared_ptr<const CommonCache>,
                           VectD&& betaVals,
                           VectD&& betaWeights,
                           std::vector<AlphaSampleInfo>&&,
-                          std::size_t ibetaOffset );
+                          std::size_t ibetaOffset,
+                          unsigned nalphatab = 0 );
 
     private:
       //Sample beta from P(beta|Ei) (line 4 of Alg. 1 in the sampling paper):
@@ -63,14 +80,22 @@ namespace NCrystal {
       // paper). NB: this needs to work with a single random number, the
       // percentile, for purposes of interpolating between two beta-rows:
       double sampleAlpha(std::size_t ibeta, double rand_percentile) const;
+      double sampleAlphaFromInfo(std::size_t ibeta, double rand_percentile) const;
+      void initAlphaTables( unsigned nalphatab );
 
       //Data:
       std::shared_ptr<const CommonCache> m_common;
       PointwiseDist m_betaSampler;
       std::vector<AlphaSampleInfo> m_alphaSamplerInfos;
       std::size_t m_ibetaOffset;
+      std::vector<TStorage> m_alphaTables;//inverse CDF tables (if nalphatab>0)
+      unsigned m_nalphatab = 0;
     };
 
+    //Implemented and instantiated in NCSABSamplerModels.cc:
+    extern template class SABSamplerAtE_Alg1<double>;
+    extern template class SABSamplerAtE_Alg1<float>;
+
     class SABSamplerAtE_NoScatter : public SABSamplerAtE {
       //Special technical sampler which doesn't actually scatter (i.e. returns
       //alpha=beta=0). For usage of edge-cases with vanishing cross-section.
@@ -45,8 +45,14 @@ namespace NCrystal {
     //multiple SABScatter instances based on the same input object will avoid
     //duplicated resource consumption.
     //
-    //The vdoslux parameter has no effect if input is not a VDOS.
-    SABScatter( const DI_ScatKnl&, unsigned vdoslux = 3, bool useCache = true );
+    //The vdoslux and tempinterp parameters have no effect if input is not a
+    //VDOS (see extractSABDataFromDynInfo in NCDynInfoUtils.hh). The sabfloat
+    //parameter selects single precision storage of derived tables, egridtol
+    //enables adaptive energy grids and nalphatab enables tabulated alpha
+    //sampling (see NCSABIntegrator.hh).
+    SABScatter( const DI_ScatKnl&, unsigned vdoslux = 3, bool useCache = true,
+                unsigned sabfloat = 0, double egridtol = 0.0, unsigned nalphatab = 0,
+                double tempinterp = 0.0 );
     SABScatter( SABData &&,
                 const VectD& energyGrid = VectD() );
     SABScatter( std::shared_ptr<const SABData>,
@@ -51,6 +51,14 @@ namespace NCrystal {
     span<const double> sliceSABAtBetaIdx_const( span<const double> sab, std::size_t nalpha, std::size_t beta_idx);
     span<double> sliceSABAtBetaIdx( span<double> sab, std::size_t nalpha, std::size_t beta_idx);
 
+    //Same for derived tables with same layout as the S-values (returns empty
+    //span for empty tables):
+    template<class TStorage>
+    span<const TStorage> sliceTableAtBetaIdx( const std::vector<TStorage>& table, std::size_t nalpha, std::size_t beta_idx);
+
+    //log(S), mapping S=0 to -inf:
+    double logSVal(double s);
+
     //interpolate "loglin" (linear in log(f), fallback to linear when undefined)
     double interpolate_loglin_fallbacklinlin(double a, double fa, double b, double fb, double x);
     double interpolate_loglin_fallbacklinlin_fast(double a, double fa, double b, double fb, double x, double logfa, double logfb);
@@ -109,10 +117,14 @@ namespace NCrystal {
       } front, back;
       bool narrow = false;//if range inside single grid bin
     };
+    //The derived tables can be stored as either double or float, and logsab
+    //can be left empty in which case log(S) values will be calculated as
+    //needed.
+    template<class TStorage>
     TailedBreakdown createTailedBreakdown( const span<const double>& alphaGrid,
                                            const span<const double>& sab,
-                                           const span<const double>& logsab,
-                                           const span<const double>& alphaIntegrals_cumul,
+                                           const span<const TStorage>& logsab,
+                                           const span<const TStorage>& alphaIntegrals_cumul,
                                            double alpha_low, double alpha_upp,
                                            const unsigned aidx_low, const unsigned aidx_upp );
 
@@ -136,6 +148,20 @@ inline NCrystal::span<double> NCrystal::SABUtils::sliceSABAtBetaIdx( span<double
   return {sab.begin() + beta_idx*nalpha, sab.begin() + (beta_idx+1)*nalpha};
 }
 
+template<class TStorage>
+inline NCrystal::span<const TStorage> NCrystal::SABUtils::sliceTableAtBetaIdx( const std::vector<TStorage>& table, std::size_t nalpha, std::size_t beta_idx)
+{
+  if ( table.empty() )
+    return {};
+  nc_assert( (beta_idx+1) * nalpha <= table.size() );
+  return {table.data() + beta_idx*nalpha, table.data() + (beta_idx+1)*nalpha};
+}
+
+inline double NCrystal::SABUtils::logSVal( double s )
+{
+  return s > 0.0 ? std::log(s) : -kInfinity;
+}
+
 inline double NCrystal::SABUtils::interpolate_loglin_fallbacklinlin(double a, double fa, double b, double fb, double x)
 {
   nc_assert ( fa>=0.0 && fb >= 0.0 );
@@ -23,11 +23,14 @@
 
 #include "NCrystal/NCScatter.hh"
 #include "NCrystal/NCSCOrientation.hh"
+#include "NCrystal/internal/NCVector.hh"
+#include <functional>
 
 namespace NCrystal {
 
   class Info;
   class PlaneProvider;
+  class GaussMos;
 
   class SCBragg : public Scatter {
   public:
@@ -68,6 +71,15 @@ namespace NCrystal {
                                      double (&resulting_neutron_direction)[3],
                                      double& delta_ekin ) const ;
 
+    //Read-only access to internal mosaicity model and reflection families
+    //(sets of demi-normals in the lab frame sharing d-spacing and xsfact,
+    //where xsfact=fsquared/(unit_cell_volume*unit_cell_natoms)), for the
+    //benefit of more specialised models building upon SCBragg:
+    const GaussMos& gaussMos() const;
+    typedef std::function<void(double inv2d, double xsfact,
+                               const std::vector<Vector>& deminormals)> FamilyVisitor;
+    void visitReflectionFamilies( const FamilyVisitor& ) const;
+
   private:
     virtual ~SCBragg();
     struct pimpl;
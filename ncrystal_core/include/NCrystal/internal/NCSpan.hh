@@ -1634,6 +1634,14 @@ namespace NCrystal {
 #ifndef NDEBUG
     if ( ! ( 0 <= idx && idx < sp.size() ) )
       NCRYSTAL_THROW(BadInput,"span_at: idx out of range");
+#endif
+    return sp[idx];
+  }
+  inline const float& span_at(const span<const float>& sp, span<const float>::index_type idx)
+  {
+#ifndef NDEBUG
+    if ( ! ( 0 <= idx && idx < sp.size() ) )
+      NCRYSTAL_THROW(BadInput,"span_at: idx out of range");
 #endif
     return sp[idx];
   }
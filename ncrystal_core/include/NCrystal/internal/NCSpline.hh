@@ -65,6 +65,7 @@ namespace NCrystal {
     void set( const Fct1D* thefct,double a,double b,double fprime_a, double fprime_b,unsigned npts = 1000,
               const std::string& name="", const std::string& description="" );
     double eval(double x) const;//<-- query the resulting lookup table
+    void eval( span<const double> x, span<double> out ) const;//<-- batch version, out[i]=eval(x[i])
     void swap(SplinedLookupTable&o);
     double getLower() const { return m_a; }
     double getUpper() const { return m_b; }
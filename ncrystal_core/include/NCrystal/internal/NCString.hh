@@ -68,6 +68,13 @@ namespace NCrystal {
   bool safe_str2dbl(const std::string&, double& result );
   bool safe_str2int(const std::string&, int& result );
 
+  //Version working directly on a character range [begin,end), avoiding the
+  //need to construct a std::string in the common case. Numbers with at most 19
+  //significant digits and moderate exponents are converted via a fast,
+  //locale-independent and exactly rounded code path. Other input is passed on
+  //to the std::string version above:
+  bool safe_str2dbl(const char * begin, const char * end, double& result );
+
   //Convenience:
   inline bool isDouble( const std::string& ss ) { double dummy; return safe_str2dbl(ss,dummy); }
   inline bool isInt( const std::string& ss ) { int dummy; return safe_str2int(ss,dummy); }
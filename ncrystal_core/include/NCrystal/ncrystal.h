@@ -108,6 +108,20 @@ extern "C" {
   NCRYSTAL_API void ncrystal_domain( ncrystal_process_t,
                                      double* ekin_low, double* ekin_high);
 
+  /*Opt-in memoisation of the last nentries (max 64) cross section queries         */
+  /*made via ncrystal_crosssection[_nonoriented] with a given process handle on    */
+  /*the calling thread. Queries with bitwise identical arguments are then          */
+  /*answered without recomputation, which helps when the same neutron state is     */
+  /*queried repeatedly with expensive (e.g. single crystal) models.                */
+  /*Memos are strictly per thread: each thread wishing to use memoisation must     */
+  /*call this function itself, gets its own memo (no locking and no sharing of     */
+  /*results between threads), and nentries=0 only disables it again for the        */
+  /*calling thread. When the process object is deleted by ncrystal_unref, the      */
+  /*memo of the calling thread is released immediately, while memos of other       */
+  /*threads are released at their next memoised query (or when they exit):         */
+  NCRYSTAL_API void ncrystal_enable_xsmemo( ncrystal_process_t,
+                                            unsigned nentries );
+
   /*Generate random scatterings (radians, eV) by neutron kinetic energy [eV].      */
   NCRYSTAL_API void ncrystal_genscatter_nonoriented( ncrystal_scatter_t,
                                                      double ekin,
@@ -150,6 +164,23 @@ extern "C" {
   NCRYSTAL_API void ncrystal_info_gethkl( ncrystal_info_t, int idx,
                                           int* h, int* k, int* l, int* multiplicity,
                                           double * dspacing, double* fsquared );
+  /*Bulk export of all HKL entries at once, into caller-provided arrays with       */
+  /*nhkl entries each (any pointer may be NULL to skip that field):               */
+  NCRYSTAL_API void ncrystal_info_gethkl_all( ncrystal_info_t,
+                                              int* h, int* k, int* l, int* multiplicity,
+                                              double * dspacing, double* fsquared );
+  /*Total number of expanded entries (demi-normals and/or eqv_hkl triplets) over   */
+  /*all HKL entries, and flags indicating which are available:                    */
+  NCRYSTAL_API unsigned long ncrystal_info_hkl_nexpanded( ncrystal_info_t,
+                                                          int* has_demi_normals,
+                                                          int* has_eqv_hkl );
+  /*Bulk export of expanded HKL info. The entries of HKL entry i are at indices   */
+  /*[offsets[i],offsets[i+1]), so offsets has nhkl+1 entries while demi_normals   */
+  /*and eqv_hkl have 3*nexpanded entries (any pointer may be NULL):               */
+  NCRYSTAL_API void ncrystal_info_gethkl_expanded( ncrystal_info_t,
+                                                   unsigned long* offsets,
+                                                   double* demi_normals,
+                                                   int* eqv_hkl );
 
   /*Access AtomInfo:                                                               */
   NCRYSTAL_API unsigned ncrystal_info_natominfo( ncrystal_info_t );/* 0=unavail    */
@@ -376,6 +407,14 @@ extern "C" {
                                                             unsigned long repeat,
                                                             double* results );
 
+  /* Look up n Miller indices (hkl has 3*n entries) in the expanded HKL lists,    */
+  /* writing the index of the HKL plane (as used in ncrystal_info_gethkl) or -1   */
+  /* for each to results_idx. Requires expanded HKL info (see NCInfo.hh).         */
+  NCRYSTAL_API void ncrystal_info_searchexpandedhkl_many( ncrystal_info_t,
+                                                          const int * hkl,
+                                                          unsigned long n,
+                                                          int * results_idx );
+
 #ifdef __cplusplus
 }
 #endif
@@ -55,11 +55,3 @@ void NCrystal::CalcBase::setRandomGenerator(NCrystal::RandomBase* rg)
   for (unsigned i=0;i<m_subcalcs.size();++i)
     m_subcalcs[i]->setRandomGenerator(rg);
 }
-
-double NCrystal::CalcBase::initDefaultRand() const
-{
-  nc_assert_always(!m_randgen);
-  m_randgen = defaultRandomGenerator();
-  nc_assert_always(m_randgen.obj());
-  return m_randgen->generate();
-}
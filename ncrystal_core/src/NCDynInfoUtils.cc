@@ -23,12 +23,17 @@
 #include "NCrystal/internal/NCMath.hh"
 #include "NCrystal/internal/NCVDOSToScatKnl.hh"
 #include "NCrystal/internal/NCSABUtils.hh"
+#include "NCrystal/internal/NCSABFactory.hh"
+#include <algorithm>
+#include <iostream>
+#include <cstdlib>
+#include <list>
 namespace NC = NCrystal;
 
 namespace NCrystal {
   namespace DICache {
     //Cache keys:
-    using VDOSKey = std::tuple<uint64_t,unsigned,const DI_VDOS*>;//(DI unique id, vdoslux 0..5, DI object)
+    using VDOSKey = std::tuple<uint64_t,unsigned,double,const DI_VDOS*>;//(DI unique id, vdoslux 0..5, tempinterp, DI object)
     using VDOSDebyeKey = std::tuple<unsigned,uint64_t,uint64_t,uint64_t,uint64_t>;//(reduced vdoslux 0..2 + rounded: elementMass, boundXS, T, TDebye)
 
     //For VDOS Debye we can potentially share work between different Info
@@ -68,9 +73,144 @@ namespace NCrystal {
                SigmaBound{std::get<2>(key)*0.001} };
     }
 
+    static bool s_verbose = getenv("NCRYSTAL_DEBUG_PHONON");
+
     //Actual worker functions producing results:
-    std::shared_ptr<const SABData> extractFromDIVDOSNoCache( unsigned vdoslux, const DI_VDOS& );
+    std::shared_ptr<const SABData> extractFromDIVDOSNoCache( unsigned vdoslux, const DI_VDOS&, double tempinterp = 0.0 );
     std::shared_ptr<const SABData> extractFromDIVDOSDebyeNoCache( const VDOSDebyeKey& );
+    double requestedEmaxFromDIVDOS( const DI_VDOS& );
+
+    //The VDOS cache above is keyed on the DI_VDOS object, but different Info
+    //objects (e.g. from cfg-strings differing only in dcutoff) might contain
+    //identical VDOS data. To avoid expanding those more than once, we keep a
+    //table (with weak references only) of kernels based on the content of
+    //their inputs. A non-zero tempinterp indicates kernels interpolated between
+    //anchor temperatures (see interpolateFromAnchors below):
+    struct VDOSContent {
+      PairDD egrid;
+      VectD density;
+      double temperature, boundXS, elementMass, requestedEmax;
+      unsigned vdoslux;
+      double tempinterp;
+      bool operator==( const VDOSContent& o ) const
+      {
+        return ( vdoslux == o.vdoslux && egrid == o.egrid && temperature == o.temperature
+                 && boundXS == o.boundXS && elementMass == o.elementMass
+                 && requestedEmax == o.requestedEmax && tempinterp == o.tempinterp
+                 && density == o.density );
+      }
+    };
+    static std::map<HashValue,std::vector<std::pair<VDOSContent,std::weak_ptr<const SABData>>>> s_vdosContentTable;
+    //Anchor kernels used for temperature interpolation are reused for other
+    //temperatures, so the most recently used ones are kept alive beyond the
+    //lifetime of the interpolated kernels. To bound memory usage, this is done
+    //in a small LRU list (older anchors only live on if still referenced
+    //elsewhere, in which case the weak references in the table above still
+    //find them):
+    static std::list<std::shared_ptr<const SABData>> s_vdosAnchorKeepAlive;
+    constexpr std::size_t vdosAnchorKeepAliveMax = 16;
+    static std::mutex s_vdosContentTable_mutex;
+
+    void touchAnchor( const std::shared_ptr<const SABData>& sabdata )
+    {
+      //Move to front of LRU list. Must be called with the mutex locked:
+      auto it = std::find( s_vdosAnchorKeepAlive.begin(), s_vdosAnchorKeepAlive.end(), sabdata );
+      if ( it != s_vdosAnchorKeepAlive.end() )
+        s_vdosAnchorKeepAlive.splice( s_vdosAnchorKeepAlive.begin(), s_vdosAnchorKeepAlive, it );
+      else
+        s_vdosAnchorKeepAlive.push_front( sabdata );
+      while ( s_vdosAnchorKeepAlive.size() > vdosAnchorKeepAliveMax )
+        s_vdosAnchorKeepAlive.pop_back();
+    }
+
+    HashValue hashVDOSContent( const VDOSContent& content )
+    {
+      HashValue hash = hashContainer(content.density);
+      hash_combine(hash,content.egrid.first);
+      hash_combine(hash,content.egrid.second);
+      hash_combine(hash,content.temperature);
+      hash_combine(hash,content.boundXS);
+      hash_combine(hash,content.elementMass);
+      hash_combine(hash,content.requestedEmax);
+      hash_combine(hash,content.vdoslux);
+      hash_combine(hash,content.tempinterp);
+      return hash;
+    }
+
+    std::shared_ptr<const SABData> lookupVDOSContent( HashValue hash, const VDOSContent& content )
+    {
+      //Must be called with the mutex locked:
+      auto it = s_vdosContentTable.find(hash);
+      if ( it == s_vdosContentTable.end() )
+        return nullptr;
+      for (auto& e : it->second) {
+        if ( e.first == content ) {
+          auto sp = e.second.lock();
+          if (sp)
+            return sp;
+        }
+      }
+      return nullptr;
+    }
+
+    VDOSContent getContent( unsigned vdoslux, const DI_VDOS& di, double tempinterp )
+    {
+      const auto& vd = di.vdosData();
+      return VDOSContent{ vd.vdos_egrid(), vd.vdos_density(), vd.temperature(), vd.boundXS().val,
+                          vd.elementMassAMU(), requestedEmaxFromDIVDOS(di), vdoslux, tempinterp };
+    }
+
+    std::shared_ptr<const SABData> extractFromVDOSContentNoCache( const VDOSContent&, bool useCache );
+
+    void pruneVDOSContentTable()
+    {
+      //Remove all expired entries (along with their copies of the VDOS
+      //content) and empty buckets. Must be called with the mutex locked:
+      for ( auto it = s_vdosContentTable.begin(); it != s_vdosContentTable.end(); ) {
+        auto& v = it->second;
+        v.erase(std::remove_if(v.begin(),v.end(),[](const std::pair<VDOSContent,std::weak_ptr<const SABData>>& e)
+                               { return e.second.expired(); }),v.end());
+        if ( v.empty() )
+          it = s_vdosContentTable.erase(it);
+        else
+          ++it;
+      }
+    }
+
+    std::shared_ptr<const SABData> extractFromVDOSContentShared( VDOSContent&& content, bool keepAlive = false )
+    {
+      //Register with clearCaches() (not while holding our own mutex, since
+      //clearCaches() invokes the cleanup functions with its own mutex locked):
+      static bool s_cleanupRegistered = [](){ registerCacheCleanupFunction( clearSABDataFromDynInfoCaches ); return true; }();
+      (void)s_cleanupRegistered;
+      const HashValue hash = hashVDOSContent(content);
+      {
+        std::lock_guard<std::mutex> guard(s_vdosContentTable_mutex);
+        auto existing = lookupVDOSContent( hash, content );
+        if ( existing && keepAlive )
+          touchAnchor( existing );
+        if (existing)
+          return existing;
+      }
+      //Expensive expansion without holding the lock:
+      auto sabdata = extractFromVDOSContentNoCache( content, true );
+      std::lock_guard<std::mutex> guard(s_vdosContentTable_mutex);
+      auto existing = lookupVDOSContent( hash, content );//other thread might have beaten us to it
+      if ( existing && keepAlive )
+        touchAnchor( existing );
+      if (existing)
+        return existing;
+      if (keepAlive)
+        touchAnchor( sabdata );
+      pruneVDOSContentTable();
+      s_vdosContentTable[hash].emplace_back(std::move(content),sabdata);
+      return sabdata;
+    }
+
+    std::shared_ptr<const SABData> extractFromDIVDOSSharedByContent( unsigned vdoslux, const DI_VDOS& di, double tempinterp )
+    {
+      return extractFromVDOSContentShared( getContent( vdoslux, di, tempinterp ) );
+    }
 
     //Factories:
     class VDOS2SABFactory : public NC::CachedFactoryBase<VDOSKey,SABData> {
@@ -79,16 +219,16 @@ namespace NCrystal {
       std::string keyToString( const VDOSKey& key ) const final
       {
         std::ostringstream ss;
-        ss<<"(DI_VDOS id="<<std::get<0>(key)<<";vdoslux="<<std::get<1>(key)<<")";
+        ss<<"(DI_VDOS id="<<std::get<0>(key)<<";vdoslux="<<std::get<1>(key)<<";tempinterp="<<std::get<2>(key)<<")";
         return ss.str();
       }
     protected:
       virtual ShPtr actualCreate( const VDOSKey& key ) final
       {
         unsigned vdoslux = std::get<1>(key);
-        const DI_VDOS* di_vdos = std::get<2>(key);
+        const DI_VDOS* di_vdos = std::get<3>(key);
         nc_assert_always( di_vdos && di_vdos->getUniqueID().value == std::get<0>(key) );
-        return extractFromDIVDOSNoCache( vdoslux, *di_vdos );
+        return extractFromDIVDOSSharedByContent( vdoslux, *di_vdos, std::get<2>(key) );
       }
     };
 
@@ -116,9 +256,9 @@ namespace NCrystal {
     static VDOS2SABFactory s_vdos2sabfactory;
     static VDOSDebye2SABFactory s_vdosdebye2sabfactory;
 
-    std::shared_ptr<const SABData> extractFromDIVDOS( unsigned vdoslux, const DI_VDOS& di )
+    std::shared_ptr<const SABData> extractFromDIVDOS( unsigned vdoslux, const DI_VDOS& di, double tempinterp )
     {
-      VDOSKey key( di.getUniqueID().value, vdoslux, &di );
+      VDOSKey key( di.getUniqueID().value, vdoslux, tempinterp, &di );
       return s_vdos2sabfactory.create(key);
     }
 
@@ -148,10 +288,12 @@ std::shared_ptr<const NC::SABData> NC::extractSABDataFromVDOSDebyeModel( double
   return DICache::extractFromDIVDOSDebye(key);
 }
 
-std::shared_ptr<const NC::SABData> NC::extractSABDataFromDynInfo( const NC::DI_ScatKnl* di, unsigned vdoslux, bool useCache )
+std::shared_ptr<const NC::SABData> NC::extractSABDataFromDynInfo( const NC::DI_ScatKnl* di, unsigned vdoslux,
+                                                                   bool useCache, double tempinterp )
 {
   nc_assert( di );
   nc_assert( vdoslux <= 5 );
+  nc_assert( tempinterp >= 0.0 && tempinterp <= 0.1 );
 
   //==> VDOSDebye
   auto di_vdosdebye = dynamic_cast<const DI_VDOSDebye*>(di);
@@ -173,8 +315,8 @@ std::shared_ptr<const NC::SABData> NC::extractSABDataFromDynInfo( const NC::DI_S
   auto di_vdos = dynamic_cast<const DI_VDOS*>(di);
   if (di_vdos) {
     if (!useCache)
-      return DICache::extractFromDIVDOSNoCache(vdoslux,*di_vdos);
-    return DICache::extractFromDIVDOS(vdoslux,*di_vdos);
+      return DICache::extractFromDIVDOSNoCache(vdoslux,*di_vdos,tempinterp);
+    return DICache::extractFromDIVDOS(vdoslux,*di_vdos,tempinterp);
   }
 
   //==> Unknown:
@@ -186,9 +328,12 @@ void NC::clearSABDataFromDynInfoCaches()
 {
   DICache::s_vdos2sabfactory.cleanup();
   DICache::s_vdosdebye2sabfactory.cleanup();
+  std::lock_guard<std::mutex> guard(DICache::s_vdosContentTable_mutex);
+  DICache::s_vdosAnchorKeepAlive.clear();
+  DICache::s_vdosContentTable.clear();
 }
 
-std::shared_ptr<const NC::SABData> NC::DICache::extractFromDIVDOSNoCache( unsigned vdoslux, const DI_VDOS& di )
+double NC::DICache::requestedEmaxFromDIVDOS( const DI_VDOS& di )
 {
   //If user specified an energy-grid with a specific upper energy, Emax,
   //this is essentially a request to expand the vdos out to that energy:
@@ -200,12 +345,224 @@ std::shared_ptr<const NC::SABData> NC::DICache::extractFromDIVDOSNoCache( unsign
     nc_assert_always(egrid->size()>=3);
     requested_Emax = egrid->size()==3 ? egrid->at(1) : egrid->back();
   }
+  return requested_Emax;
+}
+
+std::shared_ptr<const NC::SABData> NC::DICache::extractFromDIVDOSNoCache( unsigned vdoslux, const DI_VDOS& di, double tempinterp )
+{
+  if ( tempinterp > 0.0 )
+    return extractFromVDOSContentNoCache( getContent( vdoslux, di, tempinterp ), false );
+  const double requested_Emax = requestedEmaxFromDIVDOS( di );
   const auto& vd = di.vdosData();
   SABData sabdata = SABUtils::transformKernelToStdFormat( createScatteringKernel( vd, vdoslux,requested_Emax ) );
-  return std::make_shared<const SABData>(std::move(sabdata));
+  return SAB::internSABData( std::make_shared<const SABData>(std::move(sabdata)) );
 
 }
 
+namespace NCrystal {
+  namespace DICache {
+
+    //Temperature interpolation. At fixed physical momentum and energy
+    //transfers, alpha and beta both scale as 1/T, and the physical kernel is
+    //S(alpha,beta)/kT. Kernels at anchor temperatures are evaluated at the
+    //(alpha,beta) points corresponding to the target grid, after which
+    //log(S/kT) is interpolated linearly in 1/T. Since log(S(alpha,-beta)/S(alpha,beta))
+    //is exactly linear in 1/T at fixed energy transfer, detailed balance is
+    //preserved.
+
+    constexpr double anchorsPerDoubling = 8.0;
+    inline double anchorTemperature( int k ) { return std::exp2( k / anchorsPerDoubling ); }
+
+    struct AxisMap {
+      //Locate mapped points x*scale in grid, as index of lower grid point and
+      //fraction. Points beyond the grid are marked by idx=grid.size(), points
+      //below it by idx=grid.size()+1.
+      std::vector<std::size_t> idx;
+      VectD val;
+      AxisMap( const VectD& target, double scale, const VectD& grid )
+      {
+        nc_assert( grid.size() >= 2 );
+        idx.reserve(target.size());
+        val.reserve(target.size());
+        for ( auto x : target ) {
+          x *= scale;
+          val.push_back(x);
+          if ( x < grid.front() ) {
+            idx.push_back(grid.size()+1);
+          } else if ( x > grid.back() ) {
+            idx.push_back(grid.size());
+          } else {
+            auto it = std::upper_bound(grid.begin(),grid.end(),x);
+            std::size_t i = std::min<std::size_t>( std::distance(grid.begin(),it), grid.size()-1 );
+            idx.push_back( i - 1 );
+          }
+        }
+      }
+    };
+
+    //Evaluate S/T of anchor kernel on target grid (layout as SABData::sab()):
+    VectD evalAnchorOnGrid( const SABData& anchor, const VectD& alphaGrid, const VectD& betaGrid, double temperature )
+    {
+      const double scale = temperature / anchor.temperature();
+      const VectD& ag = anchor.alphaGrid();
+      const VectD& bg = anchor.betaGrid();
+      const VectD& sab = anchor.sab();
+      const std::size_t na = ag.size();
+      const std::size_t nb = bg.size();
+      AxisMap amap( alphaGrid, scale, ag );
+      AxisMap bmap( betaGrid, scale, bg );
+      const double invT = 1.0 / anchor.temperature();
+
+      //S at (alpha,beta_j) of anchor grid row j:
+      auto evalRow = [&]( std::size_t j, std::size_t ia, double a ) -> double
+      {
+        const double * row = &sab[j*na];
+        if ( ia == na )
+          return 0.0;
+        if ( ia == na+1 )
+          return ag.front() > 0.0 ? row[0] * ( a / ag.front() ) : row[0];//S is linear in alpha for small alpha
+        return SABUtils::interpolate_loglin_fallbacklinlin( ag[ia], row[ia], ag[ia+1], row[ia+1], a );
+      };
+
+      VectD out;
+      out.resize( alphaGrid.size() * betaGrid.size(), 0.0 );
+      for ( std::size_t ib = 0; ib < betaGrid.size(); ++ib ) {
+        const std::size_t jb = bmap.idx[ib];
+        if ( jb >= nb )
+          continue;//outside kernel
+        const double b = bmap.val[ib];
+        double * outrow = &out[ib*alphaGrid.size()];
+        for ( std::size_t i = 0; i < alphaGrid.size(); ++i ) {
+          const std::size_t ia = amap.idx[i];
+          const double a = amap.val[i];
+          const double s0 = evalRow( jb, ia, a );
+          const double s1 = evalRow( jb+1, ia, a );
+          outrow[i] = invT * SABUtils::interpolate_loglin_fallbacklinlin( bg[jb], s0, bg[jb+1], s1, b );
+        }
+      }
+      return out;
+    }
+
+    //Trapezoidal integration weights:
+    VectD trapezoidWeights( const VectD& grid )
+    {
+      VectD w( grid.size(), 0.0 );
+      for ( std::size_t i = 1; i < grid.size(); ++i ) {
+        const double h = 0.5 * ( grid[i] - grid[i-1] );
+        w[i-1] += h;
+        w[i] += h;
+      }
+      return w;
+    }
+
+    std::shared_ptr<const SABData> buildExactFromVDOSContent( const VDOSContent& c )
+    {
+      VDOSData vd( c.egrid, VectD(c.density), c.temperature, SigmaBound{c.boundXS}, c.elementMass );
+      SABData sabdata = SABUtils::transformKernelToStdFormat( createScatteringKernel( vd, c.vdoslux, c.requestedEmax ) );
+      return SAB::internSABData( std::make_shared<const SABData>(std::move(sabdata)) );
+    }
+
+    std::shared_ptr<const SABData> interpolateFromAnchors( const VDOSContent& c, bool useCache )
+    {
+      nc_assert( c.tempinterp > 0.0 );
+      const double T = c.temperature;
+      const double x = std::log2(T) * anchorsPerDoubling;
+      const int klow = static_cast<int>( std::floor(x) );
+      const double Ta = anchorTemperature( klow );
+      const double Tb = anchorTemperature( klow + 1 );
+      //Third anchor for error estimate, on the nearest side:
+      const double Tc = anchorTemperature( x - klow < 0.5 ? klow - 1 : klow + 2 );
+      auto buildExact = [&c,useCache]()
+      {
+        VDOSContent cexact( c );
+        cexact.tempinterp = 0.0;
+        return useCache ? extractFromVDOSContentShared( std::move(cexact) ) : buildExactFromVDOSContent( cexact );
+      };
+      if ( std::abs( T / Ta - 1.0 ) < 1e-9 || std::abs( T / Tb - 1.0 ) < 1e-9 ) {
+        //Essentially at an anchor point, just build directly:
+        return buildExact();
+      }
+
+      //NB: Anchors are always used (building them if needed), even if only a
+      //single temperature is requested, so the resulting kernel depends only on
+      //the configuration and not on what was previously loaded or cached:
+      auto getAnchor = [&c,useCache]( double Tanchor )
+      {
+        VDOSContent canchor( c );
+        canchor.temperature = Tanchor;
+        canchor.tempinterp = 0.0;
+        return useCache ? extractFromVDOSContentShared( std::move(canchor), true ) : buildExactFromVDOSContent( canchor );
+      };
+      auto sab_a = getAnchor( Ta );
+      auto sab_b = getAnchor( Tb );
+      auto sab_c = getAnchor( Tc );
+
+      //Target grid from the hotter anchor, which covers the widest physical range:
+      VectD alphaGrid = vectorTrf( sab_b->alphaGrid(), [T,Tb](double a) { return a * ( Tb / T ); } );
+      VectD betaGrid = vectorTrf( sab_b->betaGrid(), [T,Tb](double b) { return b * ( Tb / T ); } );
+      VectD fa = evalAnchorOnGrid( *sab_a, alphaGrid, betaGrid, T );
+      VectD fb = evalAnchorOnGrid( *sab_b, alphaGrid, betaGrid, T );
+      VectD fc = evalAnchorOnGrid( *sab_c, alphaGrid, betaGrid, T );
+
+      //Interpolate in u=1/T:
+      const double u = 1.0 / T, ua = 1.0 / Ta, ub = 1.0 / Tb, uc = 1.0 / Tc;
+      const double w = ( u - ua ) / ( ub - ua );
+      //Lagrange weights for quadratic interpolation:
+      const double la = ( u - ub ) * ( u - uc ) / ( ( ua - ub ) * ( ua - uc ) );
+      const double lb = ( u - ua ) * ( u - uc ) / ( ( ub - ua ) * ( ub - uc ) );
+      const double lc = ( u - ua ) * ( u - ub ) / ( ( uc - ua ) * ( uc - ub ) );
+      const VectD wa = trapezoidWeights( alphaGrid );
+      const VectD wb = trapezoidWeights( betaGrid );
+      const std::size_t na = alphaGrid.size();
+      VectD sab( fa.size() );
+      StableSum sum_s, sum_dev;
+      for ( std::size_t ib = 0; ib < betaGrid.size(); ++ib ) {
+        for ( std::size_t i = 0; i < na; ++i ) {
+          const std::size_t idx = ib * na + i;
+          const double va = fa[idx], vb = fb[idx], vc = fc[idx];
+          double s_lin, s_quad;
+          if ( va > 0.0 && vb > 0.0 ) {
+            const double loga = std::log(va), logb = std::log(vb);
+            s_lin = std::exp( loga + w * ( logb - loga ) );
+            s_quad = vc > 0.0 ? std::exp( la * loga + lb * logb + lc * std::log(vc) ) : s_lin;
+          } else {
+            s_lin = va + w * ( vb - va );
+            s_quad = la * va + lb * vb + lc * vc;
+          }
+          s_lin *= T;
+          sab[idx] = s_lin;
+          const double weight = wa[i] * wb[ib];
+          sum_s.add( s_lin * weight );
+          sum_dev.add( std::abs( s_quad * T - s_lin ) * weight );
+        }
+      }
+      const double stot = sum_s.sum();
+      const double errest = stot > 0.0 ? sum_dev.sum() / stot : kInfinity;
+
+      if ( !( errest <= c.tempinterp ) ) {
+        if (s_verbose)
+          std::cout<<"NCrystal::DICache estimated error of "<<errest<<" when interpolating kernel to T="<<T
+                   <<"K from anchors at "<<Ta<<"K and "<<Tb<<"K exceeds sabtempinterp="<<c.tempinterp
+                   <<". Building kernel directly instead."<<std::endl;
+        return buildExact();
+      }
+      if (s_verbose)
+        std::cout<<"NCrystal::DICache interpolated kernel to T="<<T<<"K from anchors at "<<Ta<<"K and "
+                 <<Tb<<"K (estimated relative error: "<<errest<<")"<<std::endl;
+
+      const double suggestedEmax = std::max( sab_a->suggestedEmax(), sab_b->suggestedEmax() );
+      return SAB::internSABData( std::make_shared<const SABData>( std::move(alphaGrid), std::move(betaGrid), std::move(sab),
+                                                                  T, SigmaBound{c.boundXS}, c.elementMass,
+                                                                  suggestedEmax ) );
+    }
+
+    std::shared_ptr<const SABData> extractFromVDOSContentNoCache( const VDOSContent& c, bool useCache )
+    {
+      return c.tempinterp > 0.0 ? interpolateFromAnchors( c, useCache ) : buildExactFromVDOSContent( c );
+    }
+  }
+}
+
 std::shared_ptr<const NC::SABData> NC::DICache::extractFromDIVDOSDebyeNoCache( const VDOSDebyeKey& key )
 {
   auto param = debyekey2params( key );
@@ -216,7 +573,7 @@ std::shared_ptr<const NC::SABData> NC::DICache::extractFromDIVDOSDebyeNoCache( c
   //constructed):
   auto vdosdata = createVDOSDebye( param.debyeTemperature, param.temperature, param.boundXS, param.elementMass );
   SABData sabdata = SABUtils::transformKernelToStdFormat( createScatteringKernel( vdosdata, param.reduced_vdoslux ) );
-  return std::make_shared<const SABData>(std::move(sabdata));
+  return SAB::internSABData( std::make_shared<const SABData>(std::move(sabdata)) );
 }
 
 
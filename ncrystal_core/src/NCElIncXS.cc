@@ -24,6 +24,47 @@
 
 namespace NC = NCrystal;
 
+namespace NCrystal {
+  namespace {
+
+    constexpr std::size_t elincxs_blocksize = 256;
+
+    void eval_1mexpmtdivt_block( const double * t, double * out, std::size_t n )
+    {
+      //Vectorisable evaluation of (1-exp(-t))/t for t>=0.0, using the same
+      //three regimes as ElIncXS::eval_1mexpmtdivt, but with exp_negarg_approx
+      //instead of std::expm1 in the intermediate regime (relative deviations
+      //are below 1e-9). All regimes are evaluated for all values (with the
+      //arguments clamped so as to never divide by zero), and the results
+      //selected at the end, since conditional evaluation prevents
+      //vectorisation:
+      nc_assert( n <= elincxs_blocksize );
+      double tmid[elincxs_blocksize];
+      double fmid[elincxs_blocksize];
+      double fsmall[elincxs_blocksize];
+      for ( std::size_t i = 0; i < n; ++i ) {
+        nc_assert( t[i] >= 0.0 );
+        tmid[i] = ncclamp( t[i], 0.01, 24.0 );
+      }
+      for ( std::size_t i = 0; i < n; ++i )
+        fmid[i] = -tmid[i];
+      exp_negarg_approx( span<const double>(fmid,fmid+n), span<double>(fmid,fmid+n) );
+      for ( std::size_t i = 0; i < n; ++i )
+        fmid[i] = ( 1.0 - fmid[i] ) / tmid[i];
+      for ( std::size_t i = 0; i < n; ++i ) {
+        const double ti = t[i];
+        fsmall[i] = ( 1 + ti * (  -0.5 + ti * 0.16666666666666666666666666666666666666666667 * ( 1.-0.25*ti ) ) );
+      }
+      for ( std::size_t i = 0; i < n; ++i )
+        tmid[i] = ( t[i] > 24.0 ? t[i] : 24.0 );
+      for ( std::size_t i = 0; i < n; ++i )
+        tmid[i] = 1.0 / tmid[i];
+      for ( std::size_t i = 0; i < n; ++i )
+        out[i] = ( t[i] < 0.01 ? fsmall[i] : ( t[i] > 24.0 ? tmid[i] : fmid[i] ) );
+    }
+  }
+}
+
 NC::ElIncXS::ElIncXS( const VectD& elm_msd,
                       const VectD& elm_bixs,
                       const VectD& elm_scale )
@@ -34,16 +75,53 @@ NC::ElIncXS::ElIncXS( const VectD& elm_msd,
 double NC::ElIncXS::evaluate(double ekin) const
 {
   //NB: The cross-section code here must be consistent with code in
-  //evaluateMonoAtomic() and sampleMu(..)
+  //evaluateMonoAtomic(), initSelectionTable() and selectElementExact(). For a
+  //single energy and a typically small number of elements, a plain loop is
+  //faster than the vectorised batch evaluation:
   constexpr double kkk = 16.0 * kPiSq * ekin2wlsqinv(1.0);
-  double e = kkk*ekin;
+  const double e = kkk*ekin;
+  const std::size_t nelem = m_msd.size();
   double xs = 0.0;
-  std::vector<PairDD >::const_iterator it(m_elm_data.begin()), itE(m_elm_data.end());
-  for (;it!=itE;++it)
-    xs += it->second * eval_1mexpmtdivt(it->first * e);
+  for ( std::size_t i = 0; i < nelem; ++i )
+    xs += m_xsscaled[i] * eval_1mexpmtdivt( m_msd[i] * e );
   return xs;
 }
 
+void NC::ElIncXS::evaluate( span<const double> ekin, span<double> out ) const
+{
+  nc_assert_always( ekin.size() == out.size() );
+  const std::size_t n = ekin.size();
+  const std::size_t nelem = m_msd.size();
+  std::fill( out.begin(), out.end(), 0.0 );
+  if ( !nelem )
+    return;
+  constexpr double kkk = 16.0 * kPiSq * ekin2wlsqinv(1.0);
+
+  //Process blocks of energies, accumulating contributions element by element
+  //(in the same order as in the scalar evaluate method):
+  double evals[elincxs_blocksize];
+  double tvals[elincxs_blocksize];
+  double fvals[elincxs_blocksize];
+  for ( std::size_t ib = 0; ib < n; ib += elincxs_blocksize ) {
+    const std::size_t nb = ncmin( elincxs_blocksize, n - ib );
+    const double * ekin_b = ekin.data() + ib;
+    double * out_b = out.data() + ib;
+    for ( std::size_t k = 0; k < nb; ++k ) {
+      nc_assert( ekin_b[k] >= 0.0 );
+      evals[k] = kkk * ekin_b[k];
+    }
+    for ( std::size_t iel = 0; iel < nelem; ++iel ) {
+      const double msd = m_msd[iel];
+      const double xsscaled = m_xsscaled[iel];
+      for ( std::size_t k = 0; k < nb; ++k )
+        tvals[k] = msd * evals[k];
+      eval_1mexpmtdivt_block( tvals, fvals, nb );
+      for ( std::size_t k = 0; k < nb; ++k )
+        out_b[k] += xsscaled * fvals[k];
+    }
+  }
+}
+
 double NC::ElIncXS::eval_1mexpmtdivt(double t)
 {
   //safe eval of (1-exp(-t))/t for t>=0.0
@@ -86,15 +164,70 @@ void NC::ElIncXS::set( const VectD& elm_msd,
   }
 
   //init:
-  {
-    //release old memory:
-    std::vector<PairDD >().swap(m_elm_data);
+  VectD( elm_msd.begin(), elm_msd.end() ).swap( m_msd );
+  VectD xsscaled;
+  xsscaled.reserve( elm_bixs.size() );
+  for (std::size_t i = 0; i < elm_msd.size(); ++i)
+    xsscaled.push_back( elm_bixs[i]*elm_scale[i] );
+  m_xsscaled.swap( xsscaled );
+  initSelectionTable();
+}
+
+void NC::ElIncXS::initSelectionTable()
+{
+  VectD().swap( m_seltab );
+  m_seltab_exp0 = m_seltab_nexp = 0;
+  const std::size_t nelem = m_msd.size();
+  if ( nelem < 2 )
+    return;
+
+  //Element selection probabilities only vary with energy in the region where
+  //t=kkk*ekin*msd is neither very small nor very large, for at least one of
+  //the elements (outside of this, the exact evaluation is used):
+  double msd_min(kInfinity), msd_max(0.0);
+  for ( auto msd : m_msd ) {
+    if ( msd > 0.0 )
+      msd_min = ncmin( msd_min, msd );
+    msd_max = ncmax( msd_max, msd );
   }
+  if ( !(msd_max>0.0) )
+    return;//all msd=0, selection never depends on energy
+  constexpr double kkk = 16.0 * kPiSq * ekin2wlsqinv(1.0);
+  int exp_low, exp_high;
+  std::frexp( 1e-4 / ( kkk * msd_max ), &exp_low );
+  std::frexp( 1e4 / ( kkk * msd_min ), &exp_high );
+  nc_assert_always( exp_high >= exp_low );
+  const int nexp = exp_high - exp_low + 1;
+  const std::size_t npts = nexp * m_seltab_nsub + 1;
+  const std::size_t ncols = nelem - 1;
 
-  m_elm_data.reserve(elm_bixs.size());
-  for (std::size_t i = 0; i < elm_msd.size(); ++i) {
-    m_elm_data.push_back(PairDD(elm_msd[i],elm_bixs[i]*elm_scale[i]));
+  VectD seltab;
+  seltab.reserve( npts * ncols );
+  VectD w( nelem );
+  for ( std::size_t j = 0; j < npts; ++j ) {
+    const int iexp = static_cast<int>( j / m_seltab_nsub );
+    const unsigned isub = j % m_seltab_nsub;
+    const double ekin = std::ldexp( 0.5 + isub * ( 0.5 / m_seltab_nsub ), exp_low + iexp );
+    const double e = kkk * ekin;
+    StableSum sum;
+    for ( std::size_t i = 0; i < nelem; ++i ) {
+      w[i] = m_xsscaled[i] * eval_1mexpmtdivt( m_msd[i] * e );
+      sum.add( w[i] );
+    }
+    const double xs = sum.sum();
+    if ( !(xs>0.0) )
+      return;//vanishing cross section at some energy, do not use table.
+    const double xsinv = 1.0 / xs;
+    double cumul = 0.0;
+    for ( std::size_t i = 0; i < ncols; ++i ) {
+      cumul += w[i];
+      seltab.push_back( cumul * xsinv );
+    }
   }
+  nc_assert_always( seltab.size() == npts * ncols );
+  m_seltab.swap( seltab );
+  m_seltab_exp0 = exp_low;
+  m_seltab_nexp = nexp;
 }
 
 double NC::ElIncXS::sampleMuMonoAtomic( RandomBase * rng, double ekin, double meanSqDisp )
@@ -133,11 +266,11 @@ double NC::ElIncXS::sampleMuMonoAtomic( RandomBase * rng, double ekin, double me
   }
 }
 
-double NC::ElIncXS::sampleMu( RandomBase * rng, double ekin )
+std::size_t NC::ElIncXS::selectElementExact( RandomBase * rng, double ekin ) const
 {
-  const std::size_t nelem = m_elm_data.size();
-  if ( nelem == 1 )
-    return sampleMuMonoAtomic( rng, ekin, m_elm_data.front().first );
+  //Select element by evaluating element-wise cross sections (returns nelem in
+  //case of vanishing cross sections).
+  const std::size_t nelem = m_msd.size();
 
   //First a little trick to provide us with an array for caching element-wise
   //cross-sections, without a memory allocation for normal use-cases (but
@@ -156,25 +289,55 @@ double NC::ElIncXS::sampleMu( RandomBase * rng, double ekin )
   constexpr double kkk = 16.0 * kPiSq * ekin2wlsqinv(1.0);
   double e = kkk*ekin;
   double xs = 0.0;
-  std::vector<PairDD >::const_iterator it(m_elm_data.begin()), itE(m_elm_data.end());
-  double * itXS = cache;
-  for (;it!=itE;++it,++itXS)
-    xs += (*itXS = it->second * eval_1mexpmtdivt(it->first * e));
+  for ( std::size_t i = 0; i < nelem; ++i )
+    xs += ( cache[i] = m_xsscaled[i] * eval_1mexpmtdivt(m_msd[i] * e) );
 
-  if (!(xs>0.0))//should not usually happen, fallback to mu=1 (i.e. no actual scattering)
-    return 1.0;
+  if (!(xs>0.0))//should not usually happen
+    return nelem;
 
   //Pick element according to cross section:
   double choice = rng->generate() * xs;
 
   //select element with simple linear search (nelem is usually very small so
   //this is likely the most efficient anyway):
-  itXS = cache;
+  double * itXS = cache;
   while ( ( choice -= *itXS ) > 0 )
     ++itXS;
 
   std::size_t choiceidx = itXS - cache;
   nc_assert(choiceidx<nelem);
+  return choiceidx;
+}
 
-  return sampleMuMonoAtomic( rng, ekin, m_elm_data[choiceidx].first );
+double NC::ElIncXS::sampleMu( RandomBase * rng, double ekin )
+{
+  const std::size_t nelem = m_msd.size();
+  if ( nelem == 1 )
+    return sampleMuMonoAtomic( rng, ekin, m_msd.front() );
+
+  std::size_t choiceidx = nelem;
+  int exponent;
+  const double mantissa = std::frexp( ekin, &exponent );//ekin=mantissa*2^exponent, mantissa in [0.5,1)
+  const int iexp = exponent - m_seltab_exp0;
+  if ( iexp >= 0 && iexp < m_seltab_nexp ) {
+    //Select element using tabulated cumulative probabilities, interpolating
+    //linearly between the two neighbouring grid points:
+    const double u = ( mantissa - 0.5 ) * ( 2.0 * m_seltab_nsub );
+    const unsigned isub = ncmin( static_cast<unsigned>( u ), m_seltab_nsub - 1 );
+    const double f = u - isub;
+    const std::size_t ncols = nelem - 1;
+    const double * c0 = &m_seltab[ ( iexp * m_seltab_nsub + isub ) * ncols ];
+    const double * c1 = c0 + ncols;
+    nc_assert( c1 + ncols <= m_seltab.data() + m_seltab.size() );
+    const double r = rng->generate();
+    choiceidx = 0;
+    while ( choiceidx < ncols && !( r < c0[choiceidx] + f * ( c1[choiceidx] - c0[choiceidx] ) ) )
+      ++choiceidx;
+  } else {
+    choiceidx = selectElementExact( rng, ekin );
+    if ( choiceidx == nelem )
+      return 1.0;//vanishing cross section, fallback to mu=1 (i.e. no actual scattering)
+  }
+  nc_assert( choiceidx < nelem );
+  return sampleMuMonoAtomic( rng, ekin, m_msd[choiceidx] );
 }
@@ -21,117 +21,215 @@
 #include "NCrystal/internal/NCEqRefl.hh"
 #include "NCrystal/NCDefs.hh"
 
+namespace NCrystal {
+
+  struct EqReflOp {
+    //(h',k',l') = M*(h,k,l), with M in row-major order:
+    int m[9];
+  };
+
+  namespace {
+
+    //Operations (besides the common identity operation, the inversion is
+    //always implied) for the various crystal systems:
+    const EqReflOp ops_Triclinic_1_2[] = {
+      {{  1,  0,  0,  0,  1,  0,  0,  0,  1 }} };
+    const EqReflOp ops_Monoclinic_3_15[] = {
+      {{  1,  0,  0,  0,  1,  0,  0,  0,  1 }},
+      {{  1,  0,  0,  0, -1,  0,  0,  0,  1 }} };
+    const EqReflOp ops_Orthorhombic_16_74[] = {
+      {{  1,  0,  0,  0,  1,  0,  0,  0,  1 }},
+      {{  1,  0,  0,  0, -1,  0,  0,  0, -1 }},
+      {{  1,  0,  0,  0, -1,  0,  0,  0,  1 }},
+      {{  1,  0,  0,  0,  1,  0,  0,  0, -1 }} };
+    const EqReflOp ops_Tetragonal_75_88[] = {
+      {{  1,  0,  0,  0,  1,  0,  0,  0,  1 }},
+      {{  0,  1,  0, -1,  0,  0,  0,  0, -1 }},
+      {{  1,  0,  0,  0,  1,  0,  0,  0, -1 }},
+      {{  0,  1,  0, -1,  0,  0,  0,  0,  1 }} };
+    const EqReflOp ops_Tetragonal_89_142[] = {
+      {{  1,  0,  0,  0,  1,  0,  0,  0,  1 }},
+      {{  0,  1,  0,  1,  0,  0,  0,  0,  1 }},
+      {{  0,  1,  0, -1,  0,  0,  0,  0, -1 }},
+      {{  1,  0,  0,  0,  1,  0,  0,  0, -1 }},
+      {{  0,  1,  0, -1,  0,  0,  0,  0,  1 }},
+      {{  1,  0,  0,  0, -1,  0,  0,  0, -1 }},
+      {{  0,  1,  0,  1,  0,  0,  0,  0, -1 }},
+      {{  1,  0,  0,  0, -1,  0,  0,  0,  1 }} };
+    const EqReflOp ops_Trigonal_143_148[] = {
+      {{  1,  0,  0,  0,  1,  0,  0,  0,  1 }},
+      {{  1,  1,  0, -1,  0,  0,  0,  0, -1 }},
+      {{  0,  1,  0, -1, -1,  0,  0,  0,  1 }} };
+    const EqReflOp ops_Trigonal_149_167[] = {
+      {{  1,  0,  0,  0,  1,  0,  0,  0,  1 }},
+      {{  1,  1,  0, -1,  0,  0,  0,  0, -1 }},
+      {{  0,  1,  0, -1, -1,  0,  0,  0,  1 }},
+      {{  0,  1,  0,  1,  0,  0,  0,  0, -1 }},
+      {{  1,  1,  0,  0, -1,  0,  0,  0,  1 }},
+      {{  1,  0,  0, -1, -1,  0,  0,  0, -1 }} };
+    const EqReflOp ops_Hexagonal_168_176[] = {
+      {{  1,  0,  0,  0,  1,  0,  0,  0,  1 }},
+      {{  1,  0,  0,  0,  1,  0,  0,  0, -1 }},
+      {{  0,  1,  0, -1, -1,  0,  0,  0, -1 }},
+      {{  0,  1,  0, -1, -1,  0,  0,  0,  1 }},
+      {{  1,  1,  0, -1,  0,  0,  0,  0,  1 }},
+      {{  1,  1,  0, -1,  0,  0,  0,  0, -1 }} };
+    const EqReflOp ops_Hexagonal_177_194[] = {
+      {{  1,  0,  0,  0,  1,  0,  0,  0,  1 }},
+      {{  0,  1,  0, -1, -1,  0,  0,  0, -1 }},
+      {{  1,  1,  0, -1,  0,  0,  0,  0, -1 }},
+      {{  1,  0,  0,  0,  1,  0,  0,  0, -1 }},
+      {{  0,  1,  0, -1, -1,  0,  0,  0,  1 }},
+      {{  1,  1,  0, -1,  0,  0,  0,  0,  1 }},
+      {{  0,  1,  0,  1,  0,  0,  0,  0,  1 }},
+      {{  1,  1,  0,  0, -1,  0,  0,  0,  1 }},
+      {{  1,  0,  0, -1, -1,  0,  0,  0,  1 }},
+      {{  0,  1,  0,  1,  0,  0,  0,  0, -1 }},
+      {{  1,  1,  0,  0, -1,  0,  0,  0, -1 }},
+      {{  1,  0,  0, -1, -1,  0,  0,  0, -1 }} };
+    const EqReflOp ops_Cubic_195_206[] = {
+      {{  1,  0,  0,  0,  1,  0,  0,  0,  1 }},
+      {{  1,  0,  0,  0, -1,  0,  0,  0, -1 }},
+      {{  1,  0,  0,  0, -1,  0,  0,  0,  1 }},
+      {{  1,  0,  0,  0,  1,  0,  0,  0, -1 }},
+      {{  0,  1,  0,  0,  0,  1,  1,  0,  0 }},
+      {{  0,  1,  0,  0,  0, -1, -1,  0,  0 }},
+      {{  0,  1,  0,  0,  0, -1,  1,  0,  0 }},
+      {{  0,  1,  0,  0,  0,  1, -1,  0,  0 }},
+      {{  0,  0,  1,  1,  0,  0,  0,  1,  0 }},
+      {{  0,  0,  1, -1,  0,  0,  0, -1,  0 }},
+      {{  0,  0,  1, -1,  0,  0,  0,  1,  0 }},
+      {{  0,  0,  1,  1,  0,  0,  0, -1,  0 }} };
+    const EqReflOp ops_Cubic_207_230[] = {
+      {{  1,  0,  0,  0,  1,  0,  0,  0,  1 }},
+      {{  1,  0,  0,  0, -1,  0,  0,  0, -1 }},
+      {{  1,  0,  0,  0, -1,  0,  0,  0,  1 }},
+      {{  1,  0,  0,  0,  1,  0,  0,  0, -1 }},
+      {{  0,  1,  0,  0,  0,  1,  1,  0,  0 }},
+      {{  0,  1,  0,  0,  0, -1, -1,  0,  0 }},
+      {{  0,  1,  0,  0,  0, -1,  1,  0,  0 }},
+      {{  0,  1,  0,  0,  0,  1, -1,  0,  0 }},
+      {{  0,  0,  1,  1,  0,  0,  0,  1,  0 }},
+      {{  0,  0,  1, -1,  0,  0,  0, -1,  0 }},
+      {{  0,  0,  1, -1,  0,  0,  0,  1,  0 }},
+      {{  0,  0,  1,  1,  0,  0,  0, -1,  0 }},
+      {{  0,  1,  0,  1,  0,  0,  0,  0,  1 }},
+      {{  0,  1,  0, -1,  0,  0,  0,  0, -1 }},
+      {{  0,  1,  0, -1,  0,  0,  0,  0,  1 }},
+      {{  0,  1,  0,  1,  0,  0,  0,  0, -1 }},
+      {{  0,  0,  1,  0,  1,  0,  1,  0,  0 }},
+      {{  0,  0,  1,  0, -1,  0, -1,  0,  0 }},
+      {{  0,  0,  1,  0, -1,  0,  1,  0,  0 }},
+      {{  0,  0,  1,  0,  1,  0, -1,  0,  0 }},
+      {{  1,  0,  0,  0,  0,  1,  0,  1,  0 }},
+      {{  1,  0,  0,  0,  0, -1,  0, -1,  0 }},
+      {{  1,  0,  0,  0,  0, -1,  0,  1,  0 }},
+      {{  1,  0,  0,  0,  0,  1,  0, -1,  0 }} };
+
+#define NCRYSTAL_EQREFL_OPS(x) ops_##x, sizeof(ops_##x)/sizeof(EqReflOp)
+  }
+}
+
+void NCrystal::EqRefl::HKLSet::insertDemi( int h, int k, int l )
+{
+  //Only insert one deminormal, not both (h,k,l) and (-h,-k,-l):
+  HKL a(h,k,l);
+  HKL am(-h,-k,-l);
+  if ( a < am )
+    a = am;
+  //Insertion sort (lists are short, so simple linear search is fastest):
+  unsigned i = m_n;
+  while ( i > 0 && a < m_data[i-1] )
+    --i;
+  if ( i > 0 && m_data[i-1] == a )
+    return;//already present
+  nc_assert_always( m_n < capacity );
+  for ( unsigned j = m_n; j > i; --j )
+    m_data[j] = m_data[j-1];
+  m_data[i] = a;
+  ++m_n;
+}
+
 NCrystal::EqRefl::EqRefl(int sg)
 {
   if (sg<1||sg>230)
     NCRYSTAL_THROW(BadInput,"Space group number is not in the range 1 to 230");
 
+  std::pair<const EqReflOp*,std::size_t> ops;
   if (sg<149) {
     if (sg<75) {
       if (sg<3)
-        m_calc = &EqRefl::calc_Triclinic_1_2;
+        ops = { NCRYSTAL_EQREFL_OPS(Triclinic_1_2) };
       else if (sg<16)
-        m_calc = &EqRefl::calc_Monoclinic_3_15;
+        ops = { NCRYSTAL_EQREFL_OPS(Monoclinic_3_15) };
       else
-        m_calc = &EqRefl::calc_Orthorhombic_16_74;
+        ops = { NCRYSTAL_EQREFL_OPS(Orthorhombic_16_74) };
     } else {
       if (sg<89)
-        m_calc = &EqRefl::calc_Tetragonal_75_88;
+        ops = { NCRYSTAL_EQREFL_OPS(Tetragonal_75_88) };
       else if (sg<143)
-        m_calc = &EqRefl::calc_Tetragonal_89_142;
+        ops = { NCRYSTAL_EQREFL_OPS(Tetragonal_89_142) };
       else
-        m_calc = &EqRefl::calc_Trigonal_143_148;
+        ops = { NCRYSTAL_EQREFL_OPS(Trigonal_143_148) };
     }
   } else {
     if (sg<195) {
       if (sg<168)
-        m_calc = &EqRefl::calc_Trigonal_149_167;
+        ops = { NCRYSTAL_EQREFL_OPS(Trigonal_149_167) };
       else if (sg<177)
-        m_calc = &EqRefl::calc_Hexagonal_168_176;
+        ops = { NCRYSTAL_EQREFL_OPS(Hexagonal_168_176) };
       else
-        m_calc = &EqRefl::calc_Hexagonal_177_194;
+        ops = { NCRYSTAL_EQREFL_OPS(Hexagonal_177_194) };
     } else {
       if (sg<207)
-        m_calc = &EqRefl::calc_Cubic_195_206;
+        ops = { NCRYSTAL_EQREFL_OPS(Cubic_195_206) };
       else
-        m_calc = &EqRefl::calc_Cubic_207_230;
+        ops = { NCRYSTAL_EQREFL_OPS(Cubic_207_230) };
     }
   }
-
-}
-
-NCrystal::EqRefl::~EqRefl()
-{
-}
-
-const std::set<NCrystal::EqRefl::HKL>& NCrystal::EqRefl::getEquivalentReflections(int h, int k, int l)
-{
-  m_planes.clear();
-  add(h,k,l);//this one is common for all spacegroups
-  (this->*m_calc)(h,k,l);
-  return m_planes;
-}
-
-void NCrystal::EqRefl::calc_Triclinic_1_2(int, int, int)
-{
-}
-
-void NCrystal::EqRefl::calc_Monoclinic_3_15(int h, int k, int l)
-{
-  add(h,-k,l);
-}
-
-void NCrystal::EqRefl::calc_Orthorhombic_16_74(int h, int k, int l)
-{
-  add(h,-k,-l); add(h,-k,l); add(h,k,-l);
-}
-
-void NCrystal::EqRefl::calc_Tetragonal_75_88(int h, int k, int l)
-{
-  add(k,-h,-l); add(h,k,-l); add(k,-h,l);
-}
-
-void NCrystal::EqRefl::calc_Tetragonal_89_142(int h, int k, int l)
-{
-  add(k,h,l); add(k,-h,-l); add(h,k,-l);
-  add(k,-h,l); add(h,-k,-l); add(k,h,-l); add(h,-k,l);
+  m_ops = ops.first;
+  m_nops = static_cast<unsigned>(ops.second);
+  nc_assert_always( m_nops>=1 && m_nops <= HKLSet::capacity );
 }
 
-void NCrystal::EqRefl::calc_Trigonal_143_148(int h, int k, int l)
-{
-  add(h+k,-h,-l); add(k,-h-k,l);
-}
-
-void NCrystal::EqRefl::calc_Trigonal_149_167(int h, int k, int l)
-{
-  add(h+k,-h,-l); add(k,-h-k,l); add(k,h,-l); add(h+k,-k,l); add(h,-h-k,-l);
-}
+#undef NCRYSTAL_EQREFL_OPS
 
-void NCrystal::EqRefl::calc_Hexagonal_168_176(int h, int k, int l)
+NCrystal::EqRefl::~EqRefl()
 {
-  add(h,k,-l); add(k,-h-k,-l); add(k,-h-k,l); add(h+k,-h,l); add(h+k,-h,-l);
 }
 
-void NCrystal::EqRefl::calc_Hexagonal_177_194(int h, int k, int l)
+void NCrystal::EqRefl::getEquivalentReflections(int h, int k, int l, HKLSet& out) const
 {
-  add(k,-h-k,-l); add(h+k,-h,-l); add(h,k,-l); add(k,-h-k,l);
-  add(h+k,-h,l); add(k,h,l); add(h+k,-k,l); add(h,-h-k,l);
-  add(k,h,-l); add(h+k,-k,-l); add(h,-h-k,-l);
+  out.clear();
+  for ( unsigned i = 0; i < m_nops; ++i ) {
+    const int * m = m_ops[i].m;
+    out.insertDemi( m[0]*h + m[1]*k + m[2]*l,
+                    m[3]*h + m[4]*k + m[5]*l,
+                    m[6]*h + m[7]*k + m[8]*l );
+  }
 }
 
-void NCrystal::EqRefl::calc_Cubic_195_206(int h, int k, int l)
+const NCrystal::EqRefl::HKLSet& NCrystal::EqRefl::getEquivalentReflections(int h, int k, int l)
 {
-  add(h,-k,-l); add(h,-k,l); add(h,k,-l);
-  add(k,l,h); add(k,-l,-h); add(k,-l,h); add(k,l,-h);
-  add(l,h,k); add(l,-h,-k); add(l,-h,k); add(l,h,-k);
+  getEquivalentReflections(h,k,l,m_planes);
+  return m_planes;
 }
 
-void NCrystal::EqRefl::calc_Cubic_207_230(int h, int k, int l)
+void NCrystal::EqRefl::getEquivalentReflections( const int * hkl_in, std::size_t n,
+                                                 std::vector<int>& out_hkl,
+                                                 std::vector<std::size_t>& out_offsets ) const
 {
-  add(h,-k,-l); add(h,-k,l); add(h,k,-l);
-  add(k,l,h); add(k,-l,-h); add(k,-l,h); add(k,l,-h);
-  add(l,h,k); add(l,-h,-k); add(l,-h,k); add(l,h,-k);
-  add(k,h,l); add(k,-h,-l); add(k,-h,l); add(k,h,-l);
-  add(l,k,h); add(l,-k,-h); add(l,-k,h); add(l,k,-h);
-  add(h,l,k); add(h,-l,-k); add(h,-l,k); add(h,l,-k);
+  out_offsets.reserve( out_offsets.size() + n + 1 );
+  out_hkl.reserve( out_hkl.size() + 3 * n * m_nops );//upper bound
+  out_offsets.push_back( out_hkl.size() / 3 );
+  HKLSet buf;
+  for ( std::size_t i = 0; i < n; ++i, hkl_in += 3 ) {
+    getEquivalentReflections( hkl_in[0], hkl_in[1], hkl_in[2], buf );
+    for ( const auto& e : buf ) {
+      out_hkl.push_back(e.h);
+      out_hkl.push_back(e.k);
+      out_hkl.push_back(e.l);
+    }
+    out_offsets.push_back( out_hkl.size() / 3 );
+  }
 }
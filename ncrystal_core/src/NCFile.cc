@@ -19,9 +19,19 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "NCrystal/NCFile.hh"
+#include "NCrystal/NCException.hh"
 
 #include <fstream>
 #include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+#if defined(__unix__) || defined(__unix) || ( defined(__APPLE__) && defined(__MACH__) )
+#  define NCRYSTAL_FILE_HAS_MMAP
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
 namespace NC = NCrystal;
 
 namespace NCrystal {
@@ -192,6 +202,226 @@ namespace NCrystal {
     bool m_more;
   };
 
+
+  class MemRangeTextInputStream : public TextInputStream {
+  public:
+    //Stream lines directly from a range of memory which is kept alive by the
+    //(optional) owner object.
+
+    virtual ~MemRangeTextInputStream(){}
+
+    MemRangeTextInputStream(const std::string& name, const char * begin, const char * end,
+                            std::shared_ptr<const void> owner )
+      : TextInputStream(name),
+        m_pos(begin),
+        m_end(end),
+        m_owner(std::move(owner))
+    {
+      nc_assert(begin&&end>=begin);
+    }
+
+    virtual bool getLine(std::string& line) {
+      if (m_pos==m_end) {
+        line.clear();
+        return false;
+      }
+      const char * eol = static_cast<const char*>(std::memchr(m_pos,'\n',m_end-m_pos));
+      if (!eol)
+        eol = m_end;
+      line.assign(m_pos,eol-m_pos);
+      m_pos = ( eol==m_end ? m_end : eol + 1 );
+      return true;
+    }
+
+    virtual bool moreLines() const
+    {
+      return m_pos!=m_end;
+    }
+
+    virtual const char * streamType() const
+    {
+      return "archive";
+    }
+
+  private:
+    const char * m_pos;
+    const char * m_end;
+    std::shared_ptr<const void> m_owner;
+  };
+
+  class DataArchive {
+  public:
+    //Read-only view of packed data archive. The file format is (all integers
+    //are unsigned 64 bit little-endian values):
+    //
+    //  16 bytes magic "NCRYSTALARCHIVE1"
+    //  number of entries, N
+    //  N index entries of: name length, data offset, data size, name chars
+    //  data of all entries (offsets are relative to the start of the file).
+    //
+    DataArchive(const std::string& path)
+      : m_path(path)
+    {
+#ifdef NCRYSTAL_FILE_HAS_MMAP
+      int fd = ::open(path.c_str(),O_RDONLY);
+      if (fd<0)
+        NCRYSTAL_THROW2(FileNotFound,"Could not open data archive: "<<path);
+      struct stat st;
+      if ( ::fstat(fd,&st)!=0 ) {
+        ::close(fd);
+        NCRYSTAL_THROW2(DataLoadError,"Could not determine size of data archive: "<<path);
+      }
+      m_size = static_cast<std::size_t>(st.st_size);
+      if (m_size) {
+        void * addr = ::mmap(nullptr,m_size,PROT_READ,MAP_PRIVATE,fd,0);
+        if ( addr == MAP_FAILED ) {
+          ::close(fd);
+          NCRYSTAL_THROW2(DataLoadError,"Could not memory-map data archive: "<<path);
+        }
+        m_data = static_cast<const char*>(addr);
+      }
+      ::close(fd);//mapping stays valid after closing
+#else
+      std::ifstream f(path.c_str(),std::ios::in|std::ios::binary);
+      if (!f.good())
+        NCRYSTAL_THROW2(FileNotFound,"Could not open data archive: "<<path);
+      m_buffer.assign(std::istreambuf_iterator<char>(f),std::istreambuf_iterator<char>());
+      m_size = m_buffer.size();
+      m_data = m_buffer.data();
+#endif
+      try {
+        readIndex();
+      } catch (...) {
+        unmap();
+        throw;
+      }
+    }
+
+    ~DataArchive()
+    {
+      unmap();
+    }
+
+    const std::string& path() const { return m_path; }
+
+    //Find entry (returns false if not present):
+    bool find(const std::string& name, const char*& begin, const char*& end) const
+    {
+      auto it = m_index.find(name);
+      if ( it == m_index.end() )
+        return false;
+      begin = m_data + it->second.first;
+      end = begin + it->second.second;
+      return true;
+    }
+
+    DataArchive( const DataArchive& ) = delete;
+    DataArchive& operator=( const DataArchive& ) = delete;
+
+  private:
+    void unmap()
+    {
+#ifdef NCRYSTAL_FILE_HAS_MMAP
+      if (m_data)
+        ::munmap(const_cast<char*>(m_data),m_size);
+#endif
+      m_data = nullptr;
+    }
+
+    uint64_t readUInt64(std::size_t& pos) const
+    {
+      if ( m_size < 8 || pos > m_size - 8 )
+        NCRYSTAL_THROW2(DataLoadError,"Data archive is truncated or corrupted: "<<m_path);
+      uint64_t v = 0;
+      for ( unsigned i = 0; i < 8; ++i )
+        v |= static_cast<uint64_t>(static_cast<unsigned char>(m_data[pos+i])) << (8*i);
+      pos += 8;
+      return v;
+    }
+
+    void readIndex()
+    {
+      static const char magic[] = "NCRYSTALARCHIVE1";
+      const std::size_t nmagic = sizeof(magic)-1;
+      if ( m_size < nmagic || std::memcmp(m_data,magic,nmagic)!=0 )
+        NCRYSTAL_THROW2(DataLoadError,"File is not an NCrystal data archive: "<<m_path);
+      std::size_t pos = nmagic;
+      const uint64_t n = readUInt64(pos);
+      if ( n > m_size )
+        NCRYSTAL_THROW2(DataLoadError,"Data archive is truncated or corrupted: "<<m_path);
+      m_index.reserve(n);
+      for ( uint64_t i = 0; i < n; ++i ) {
+        const uint64_t namelength = readUInt64(pos);
+        const uint64_t offset = readUInt64(pos);
+        const uint64_t size = readUInt64(pos);
+        if ( namelength > m_size - pos || offset > m_size || size > m_size - offset )
+          NCRYSTAL_THROW2(DataLoadError,"Data archive is truncated or corrupted: "<<m_path);
+        std::string name(m_data+pos,namelength);
+        pos += namelength;
+        if ( !m_index.emplace(std::move(name),std::make_pair(offset,size)).second )
+          NCRYSTAL_THROW2(DataLoadError,"Data archive has multiple entries with the same name: "<<m_path);
+      }
+    }
+
+    std::string m_path;
+    const char * m_data = nullptr;
+    std::size_t m_size = 0;
+#ifndef NCRYSTAL_FILE_HAS_MMAP
+    std::string m_buffer;
+#endif
+    std::unordered_map<std::string,std::pair<uint64_t,uint64_t>> m_index;
+  };
+
+  class ArchiveTextInputManager : public TextInputManager {
+  public:
+    ArchiveTextInputManager( const std::string& path, bool allowfallback )
+      : m_archive(std::make_shared<DataArchive>(path)),
+        m_allowfallback(allowfallback)
+    {
+    }
+    virtual ~ArchiveTextInputManager(){}
+    std::unique_ptr<TextInputStream> createTextInputStream( const std::string& name ) final
+    {
+      return createStreamFromArchive(m_archive,name);
+    }
+    bool allowFallbackToUsualDefaults() final { return m_allowfallback; }
+
+    static std::unique_ptr<TextInputStream> createStreamFromArchive( const std::shared_ptr<const DataArchive>& archive,
+                                                                     const std::string& name )
+    {
+      const char * begin;
+      const char * end;
+      if ( !archive->find(name,begin,end) )
+        return nullptr;
+      return std::make_unique<MemRangeTextInputStream>(name,begin,end,archive);
+    }
+  private:
+    std::shared_ptr<const DataArchive> m_archive;
+    bool m_allowfallback;
+  };
+
+  static std::shared_ptr<const DataArchive> getEnvDataArchive()
+  {
+    //Opened on first usage (and kept open):
+    static std::mutex s_mutex;
+    static bool s_checked = false;
+    static std::shared_ptr<const DataArchive> s_archive;
+    std::lock_guard<std::mutex> guard(s_mutex);
+    if (!s_checked) {
+      const char * envpath = std::getenv("NCRYSTAL_DATA_ARCHIVE");
+      if ( envpath && envpath[0] )
+        s_archive = std::make_shared<const DataArchive>(envpath);//throws in case of problems
+      s_checked = true;
+    }
+    return s_archive;
+  }
+
+}
+
+std::unique_ptr<NC::TextInputManager> NC::createArchiveTextInputManager( const std::string& archive_path,
+                                                                         bool allowFallbackToUsualDefaults )
+{
+  return std::make_unique<ArchiveTextInputManager>(archive_path,allowFallbackToUsualDefaults);
 }
 
 std::unique_ptr<NC::TextInputStream> NC::createTextInputStream( const std::string& sourcename )
@@ -209,6 +439,14 @@ std::unique_ptr<NC::TextInputStream> NC::createTextInputStream( const std::strin
     }
   }
 
+  //Look in data archive from NCRYSTAL_DATA_ARCHIVE, if any:
+  auto archive = getEnvDataArchive();
+  if (archive) {
+    auto stream = ArchiveTextInputManager::createStreamFromArchive(archive,sourcename);
+    if (stream!=nullptr)
+      return stream;
+  }
+
   //Fall back to looking for on-disk sources, where sourcename are the filenames
   //passed to find_file:
   std::string resolved_name = find_file(sourcename);
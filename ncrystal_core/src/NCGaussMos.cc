@@ -139,6 +139,47 @@ double NC::GaussMos::calcRawCrossSectionValueInit(InteractionPars& ip, double co
   }
 }
 
+inline void NC::GaussMos::addContributions( InteractionPars& ip,
+                                            const NC::Vector& normal,
+                                            double dot,
+                                            double sdotcptsq,
+                                            double ds,
+                                            double cta,
+                                            std::vector<NC::GaussMos::ScatCache>& cache,
+                                            VectD& xs_commul,
+                                            double xsoffset,
+                                            double& xssum ) const
+{
+  //Called when the combined check in calcCrossSections indicates that at least
+  //one of normal and anti-normal is within the truncated Gauss:
+  double Am = ncmax( 0.0, cta - ds );
+  if ( sdotcptsq > Am*Am ) {
+    //anti-normal is within truncated Gauss
+    double xs = calcRawCrossSectionValue(ip, dot );
+    if (xs) {
+      xs_commul.push_back(xsoffset + (xssum += xs));
+      cache.emplace_back(-normal, ip.m_inv2dsp);
+    }
+  }
+  double Ap = ncmax( 0.0, cta + ds );
+  if ( sdotcptsq > Ap*Ap ) {
+    //normal is within truncated Gauss
+    double xs = calcRawCrossSectionValue(ip, -dot );
+    if (xs) {
+      xs_commul.push_back(xsoffset + (xssum += xs));
+      cache.emplace_back(normal, ip.m_inv2dsp);
+    }
+  }
+}
+
+namespace NCrystal {
+  namespace {
+    //Number of demi-normals for which the truncation test is carried out at a
+    //time in the SoA version of calcCrossSections:
+    constexpr std::size_t gaussmos_blocksize = 128;
+  }
+}
+
 double NC::GaussMos::calcCrossSections( InteractionPars& ip,
                                         const NC::Vector& indir,
                                         const std::vector<NC::Vector>& deminormals,
@@ -165,29 +206,82 @@ double NC::GaussMos::calcCrossSections( InteractionPars& ip,
       continue;
 
     //At least one of the two normals should contribute, so deal with them:
-    double Am = ncmax( 0.0, cta - ds );
-    if ( sdotcptsq > Am*Am ) {
-      //anti-normal is within truncated Gauss
-      double xs = calcRawCrossSectionValue(ip, dot );
-      if (xs) {
-        xs_commul.push_back(xsoffset + (xssum += xs));
-        cache.emplace_back(-normal, ip.m_inv2dsp);
-      }
+    addContributions( ip, normal, dot, sdotcptsq, ds, cta, cache, xs_commul, xsoffset, xssum );
+  }
+  return xssum;
+}
+
+double NC::GaussMos::calcCrossSections( InteractionPars& ip,
+                                        const NC::Vector& indir,
+                                        const NC::GaussMos::DemiNormals& deminormals,
+                                        std::vector<NC::GaussMos::ScatCache>& cache,
+                                        VectD& xs_commul ) const
+{
+  nc_assert(ip.isValid()&&ip.m_wl>0);
+  nc_assert(indir.isUnitVector());
+  double xsoffset = xs_commul.empty() ? 0.0 : xs_commul.back();
+  double xssum(0.0);
+  const std::size_t n = deminormals.size();
+  if (!n)
+    return xssum;
+  const double cptsq = ip.m_cos_perfect_theta_sq;
+  const double spt = ip.m_sin_perfect_theta;
+  const double cta = m_gos.getCosTruncangle();
+  const double ix = indir.x();
+  const double iy = indir.y();
+  const double iz = indir.z();
+  const double * dnx = deminormals.xData();
+  const double * dny = deminormals.yData();
+  const double * dnz = deminormals.zData();
+
+  //Process in blocks. Within each block, the dot products and the combined
+  //truncation check for normal and anti-normal are done in simple branch-free
+  //loops over local arrays, after which the (typically very few) demi-normals
+  //passing the check are handled one at a time. The arithmetic
+  //is the same as in the std::vector<Vector> version above, so results are
+  //identical:
+  double dots[gaussmos_blocksize];
+  double margin[gaussmos_blocksize];
+  for ( std::size_t ib = 0; ib < n; ib += gaussmos_blocksize ) {
+    const std::size_t nb = ncmin( gaussmos_blocksize, n - ib );
+    const double * bx = dnx + ib;
+    const double * by = dny + ib;
+    const double * bz = dnz + ib;
+    for ( std::size_t i = 0; i < nb; ++i )
+      dots[i] = bx[i]*ix + by[i]*iy + bz[i]*iz;
+    //Combined check, sdotcptsq > A0*A0, expressed as a positive margin (with
+    //IEEE arithmetic a-b>0 exactly when a>b):
+    for ( std::size_t i = 0; i < nb; ++i ) {
+      const double dot = dots[i];
+      const double sdotcptsq = (1.0 - dot * dot)*cptsq;
+      //A0 = max(0,A), written without a comparison (exact, since both A+|A|
+      //and the multiplication by 0.5 are exact operations):
+      const double A = cta - ncabs( dot * spt );
+      const double A0 = 0.5 * ( A + ncabs(A) );
+      margin[i] = sdotcptsq - A0*A0;
     }
-    double Ap = ncmax( 0.0, cta + ds );
-    if ( sdotcptsq > Ap*Ap ) {
-      //normal is within truncated Gauss
-      double xs = calcRawCrossSectionValue(ip, -dot );
-      if (xs) {
-        xs_commul.push_back(xsoffset + (xssum += xs));
-        cache.emplace_back(normal, ip.m_inv2dsp);
-      }
+    //Handle the few demi-normals passing the check (the branch is rarely taken
+    //and therefore well predicted):
+    for ( std::size_t i = 0; i < nb; ++i ) {
+      if ( !( margin[i] > 0.0 ) )
+        continue;
+      const double dot = dots[i];
+      addContributions( ip, Vector(bx[i],by[i],bz[i]), dot, (1.0 - dot * dot)*cptsq, dot * spt,
+                        cta, cache, xs_commul, xsoffset, xssum );
     }
-
   }
   return xssum;
 }
 
+std::vector<NC::Vector> NC::GaussMos::DemiNormals::toVector() const
+{
+  std::vector<Vector> v;
+  v.reserve(size());
+  for ( std::size_t i = 0; i < size(); ++i )
+    v.emplace_back(m_x[i],m_y[i],m_z[i]);
+  return v;
+}
+
 void NC::GaussMos::genScat( RandomBase* rand, const ScatCache& cache, double wl_raw, const NC::Vector& indir, NC::Vector& outdir) const
 {
   nc_assert(wl_raw>0.);
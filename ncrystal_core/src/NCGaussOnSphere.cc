@@ -23,6 +23,7 @@
 #include "NCrystal/internal/NCRandUtils.hh"
 #include <iostream>
 #include <cstdlib>
+#include <limits>
 namespace NC = NCrystal;
 
 namespace NCrystal {
@@ -199,6 +200,7 @@ NC::GaussOnSphere::GaussOnSphere()
     m_truncangle(-1.0),
     m_sigma(-1.0),
     m_numint_accuracy(-1.0),
+    m_gaussoverlay_safety(-1.0),
     m_prec(-1),
     m_sta(-1.0),
     m_stat_genpointworst(0),
@@ -220,6 +222,7 @@ NC::GaussOnSphere::GaussOnSphere( double sigma, double trunc_angle, double prec
     m_truncangle(-1.0),
     m_sigma(-1.0),
     m_numint_accuracy(-1.0),
+    m_gaussoverlay_safety(-1.0),
     m_prec(-1),
     m_sta(-1.0),
     m_stat_genpointworst(0),
@@ -286,6 +289,17 @@ void NC::GaussOnSphere::set(double sigma, double trunc_angle, double prec ) {
   m_expfact = -0.5/(sigma*sigma);
   m_norm = calcNormFactor(sigma,trunc_angle);
 
+  //Bound on the rounding errors in genPointOnCircle when comparing the density
+  //at a sampled point with the Gaussian overlay (both evaluated exactly, not via
+  //lookup tables). Absolute errors of a few epsilon in cos(delta) give absolute
+  //errors of at most pi*epsilon in delta^2 (for delta<=pi/2), which enter the
+  //exponent multiplied by |m_expfact|. Relative errors of the exponents
+  //themselves are of order epsilon times their magnitude (at most
+  //|m_expfact|*trunc_angle^2), and each of the three exp_negarg_approx calls
+  //involved adds at most 0.7e-10. Generous margins are applied to all terms:
+  m_gaussoverlay_safety = ( 1.0 + 1e-9 ) * std::exp( -64.0 * std::numeric_limits<double>::epsilon()
+                                                     * m_expfact * ( 1.0 + trunc_angle*trunc_angle ) );
+
   //analyse prec and trunc_angle parameters to establish some overall settings:
   nc_assert(prec>0);
   if (prec<1.0) {
@@ -458,25 +472,76 @@ bool NC::GaussOnSphere::genPointOnCircle( RandomBase*rand, double cg, double sg,
     return false;
   double tmax = ( cos_tmax<=-1.0 ? kPi : std::acos(cos_tmax) );
 
-  //The highest contribution is at t=0, at which cos(delta) = cd. Generate t via MC-rejection.
-  double densitymax = evalCosXInRange(cd)*1.00000001;//1.00000001 is overlay safety
-  const int maxtriesplus1(1001);//we should usually use *much* fewer tries than this (averaging around 3-6 depending on parameters).
+  //The highest contribution is at t=0, at which cos(delta) = cd, and the
+  //density falls monotonically with |t|. Generate t via MC-rejection, using one
+  //of two different overlay functions. Since f(x)=acos(1-x)^2 is convex with
+  //slope 2 at x=0, and since 1-cos(t) >= (1-cos(tmax))*t^2/tmax^2 for
+  //|t|<=tmax, it holds that delta(t)^2 >= delta(0)^2 + c*sasg*t^2, with
+  //c=2*(1-cos(tmax))/tmax^2. Consequently, the density is bounded from above
+  //by a Gaussian in t which is a tight overlay for small angles, and from which
+  //t can be sampled directly. This bound holds for the exact density, but not
+  //for the lookup table (whose relative errors can be large in the far tails),
+  //so with the Gaussian overlay the density is evaluated directly and the
+  //overlay only needs a safety factor covering rounding errors.
+  //
+  //Similarly, since f'(x)=2*delta/sin(delta) is largest at the truncation
+  //angle, and since 1-cos(t)<=t^2/2, it holds that delta(t)^2 <= delta(0)^2 +
+  //(truncangle/sin(truncangle))*sasg*t^2. This gives a Gaussian lower bound on
+  //the density, which is almost as tight as the overlay. It is used as a
+  //"squeeze" to accept most sampled values without evaluating the density.
+  //
+  //When the allowed range of t is narrow compared to the width of the Gaussian
+  //(or for extremely narrow Gaussians where rounding errors become
+  //significant), the density is instead overlaid by a flat distribution of t
+  //values in the allowed range, using the lookup table for the density.
+  const double tmaxsq = tmax*tmax;
+  const double ekt = m_expfact * sasg * 2.0 * ( 1.0 - ncmax(-1.0,cos_tmax) ) / tmaxsq;//gaussian overlay is exp(ekt*t^2)
+  nc_assert(ekt<0.0);
+  const bool gaussoverlay = ( ekt*tmaxsq < -0.78125 //tmax > 1.25 sigma_t, where gaussian overlay is most efficient
+                              && m_gaussoverlay_safety < 1.01 );
+  const double sigma_t = gaussoverlay ? 1.0/std::sqrt(-2.0*ekt) : 0.0;
+  //Squeeze accepts when u*overlay <= lower bound, for which it suffices that
+  //u*safety <= 1+ekt_squeeze*t^2 (since exp(y)>=1+y):
+  const double ekt_squeeze = ( gaussoverlay ? m_expfact * sasg * m_truncangle / m_sta - ekt : 0.0 );
+  nc_assert( ekt_squeeze <= 0.0 );
+  double densitymax = ( gaussoverlay ? -1.0 : evalCosXInRange(cd)*1.00000001 );//1.00000001 is overlay safety
+  double t(0.0);
+  const int maxtriesplus1(1001);//we should usually use *much* fewer tries than this (averaging close to 1-2 depending on parameters).
   int triesleft = maxtriesplus1;
   while (--triesleft) {
-    ct = cos_mpipi( rand->generate()*tmax );//generate t uniformly in allowed range
-    double cd_at_t = sasg*ct+cacg;
-    double density_at_t = evalCosXInRange(cd_at_t);
-    if ( density_at_t > densitymax ) {
+    double overlay, density_at_t, u;
+    if (gaussoverlay) {
+      t = randNorm(rand) * sigma_t;//generate t from gaussian overlay
+      if ( !( ncabs(t) < tmax ) )
+        continue;
+      u = rand->generate();
+      const double tsq = t*t;
+      ct = cos_mpipi( t );
+      if ( u * m_gaussoverlay_safety <= 1.0 + ekt_squeeze * tsq )
+        break;//accepted by squeeze
+      if ( densitymax < 0.0 )
+        densitymax = evalXInRange( std::acos( ncmin(1.0,cd) ) ) * m_gaussoverlay_safety;
+      overlay = densitymax * exp_negarg_approx( ekt*tsq );
+      density_at_t = evalXInRange( std::acos( ncmin( 1.0, sasg*ct+cacg ) ) );
+      nc_assert( density_at_t <= overlay );
+    } else {
+      t = rand->generate()*tmax;//generate t uniformly in allowed range
+      overlay = densitymax;
+      ct = cos_mpipi( t );
+      density_at_t = evalCosXInRange( sasg*ct+cacg );
+      u = rand->generate();
+    }
+    if ( density_at_t > overlay ) {
       static bool first = true;
       if (first) {
         first = false;
         std::cout<<"NCrystal WARNING: Problems sampling with rejection method during GaussOnSphere::genPointOnCircle "
           "invocation. Overlay value was not larger than actual cross-section value at sampled point "
-          "(overshot by factor of "<<(densitymax?density_at_t/densitymax:kInfinity)<<"). Further warnings"
+          "(overshot by factor of "<<(overlay?density_at_t/overlay:kInfinity)<<"). Further warnings"
           " of this type will not be emitted."<<std::endl;
       }
     }
-    if ( density_at_t > densitymax * rand->generate())
+    if ( density_at_t > overlay * u )
       break;
   }
   if (m_stat_genpointworst) {
@@ -496,7 +561,10 @@ bool NC::GaussOnSphere::genPointOnCircle( RandomBase*rand, double cg, double sg,
     return false;
   }
   st = std::sqrt(1.0-ct*ct);
-  st = (rand->generate()>0.5?st:-st);//pick t in [-pi,pi], not just in [0,pi]
+  if (gaussoverlay)
+    st = (t<0.0?-st:st);//t already sampled in [-tmax,tmax]
+  else
+    st = (rand->generate()>0.5?st:-st);//pick t in [-pi,pi], not just in [0,pi]
   return true;
 }
 
@@ -23,9 +23,11 @@
 #include "NCrystal/internal/NCMath.hh"
 #include "NCrystal/internal/NCString.hh"
 #include "NCrystal/internal/NCIter.hh"
+#include "NCrystal/internal/NCSABFactory.hh"
 #include <algorithm>
 #include <cstring>//for memcpy
 #include <cstdlib>
+#include <unordered_map>
 namespace NC=NCrystal;
 
 NC::Info::Info()
@@ -46,6 +48,57 @@ NC::Info::~Info() = default;
 
 namespace NCrystal {
 
+  static std::atomic<bool> s_hklarrays_enabled( std::getenv("NCRYSTAL_HKLARRAYS") ? true : false );
+
+  static std::unique_ptr<const HKLArrays> createHKLArrays( HKLList& hkllist )
+  {
+    //Move expanded info out of the HKLInfo objects and into flat arrays,
+    //leaving just the HKLInfo scalar fields behind:
+    std::unique_ptr<HKLArrays> arr = std::make_unique<HKLArrays>();
+    const bool has_normals = !hkllist.empty() && !hkllist.front().demi_normals.empty();
+    const bool has_eqv_hkl = has_normals && hkllist.front().eqv_hkl;
+    std::size_t ntot_normals(0);
+    for (const auto& e : hkllist)
+      ntot_normals += e.demi_normals.size();
+    const std::size_t n = hkllist.size();
+    arr->dspacing.reserve(n);
+    arr->fsquared.reserve(n);
+    arr->h.reserve(n);
+    arr->k.reserve(n);
+    arr->l.reserve(n);
+    arr->multiplicity.reserve(n);
+    if ( has_normals ) {
+      arr->normals_offset.reserve(n+1);
+      arr->normal_x.reserve(ntot_normals);
+      arr->normal_y.reserve(ntot_normals);
+      arr->normal_z.reserve(ntot_normals);
+      arr->normals_offset.push_back(0);
+    }
+    if ( has_eqv_hkl )
+      arr->eqv_hkl.reserve(ntot_normals*3);
+    for (auto& e : hkllist) {
+      arr->dspacing.push_back(e.dspacing);
+      arr->fsquared.push_back(e.fsquared);
+      arr->h.push_back(e.h);
+      arr->k.push_back(e.k);
+      arr->l.push_back(e.l);
+      arr->multiplicity.push_back(e.multiplicity);
+      if ( !has_normals )
+        continue;
+      for (const auto& nn : e.demi_normals) {
+        arr->normal_x.push_back(nn.x);
+        arr->normal_y.push_back(nn.y);
+        arr->normal_z.push_back(nn.z);
+      }
+      if ( has_eqv_hkl )
+        arr->eqv_hkl.insert(arr->eqv_hkl.end(),&e.eqv_hkl[0],&e.eqv_hkl[0]+3*e.demi_normals.size());
+      arr->normals_offset.push_back(arr->normal_x.size());
+      std::vector<HKLInfo::Normal>().swap(e.demi_normals);
+      e.eqv_hkl.reset();
+    }
+    return std::unique_ptr<const HKLArrays>(std::move(arr));
+  }
+
   bool dhkl_compare( const NC::HKLInfo& rh, const NC::HKLInfo& lh )
   {
     if( ncabs(lh.dspacing-rh.dspacing) > 1.0e-6 )
@@ -247,6 +300,10 @@ void NC::Info::objectDone()
       NCRYSTAL_THROW(LogicError,"Expanded HKL info (eqv_hkl) provided, but multiplicity is not an even number.");
   }
 
+  //Optionally move HKL info to structure-of-arrays storage:
+  if ( hasHKLInfo() && s_hklarrays_enabled )
+    m_hklarrays = createHKLArrays( m_hkllist );
+
   if (hasStructureInfo()) {
     if ( ! (m_structinfo.volume > 0.0) )
       NCRYSTAL_THROW2(BadInput,"StructureInfo volume not a positive number: "<<m_structinfo.volume);
@@ -487,25 +544,125 @@ void NC::Info::ensureNoLock()
     NCRYSTAL_THROW(LogicError,"Modification of Info object after it is locked is forbidden");
 }
 
-NC::HKLList::const_iterator NC::Info::searchExpandedHKL(short h, short k, short l) const
+void NC::enableHKLArrayStorage( bool b )
 {
-  nc_assert_always(hasHKLInfo());
-  nc_assert_always(hasExpandedHKLInfo());
+  s_hklarrays_enabled = b;
+}
+
+bool NC::hklArrayStorageEnabled()
+{
+  return s_hklarrays_enabled;
+}
 
-  HKLList::const_iterator it(hklBegin()), itE(hklEnd());
-  for(;it!=itE;++it)
+void NC::Info::expandHKLList() const
+{
+  //Populate the demi_normals and eqv_hkl fields of the HKLInfo objects from
+  //the HKLArrays (once only, and in a thread-safe manner):
+  nc_assert(m_hklarrays);
+  std::call_once(m_hkllist_expandflag,[this]()
   {
-    for(unsigned i=0;i < it->multiplicity/2;i++)
-    {
-      nc_assert(it->eqv_hkl);
-      if( (it->eqv_hkl[i*3]==h && it->eqv_hkl[i*3+1]==k && it->eqv_hkl[i*3+2]==l) ||
-          (it->eqv_hkl[i*3]==-h && it->eqv_hkl[i*3+1]==-k && it->eqv_hkl[i*3+2]==-l) )
-      {
-        return it;
+    const HKLArrays& arr = *m_hklarrays;
+    nc_assert_always(arr.size()==m_hkllist.size());
+    if (!arr.hasNormals())
+      return;
+    for (std::size_t i = 0; i < m_hkllist.size(); ++i) {
+      HKLInfo& e = m_hkllist[i];
+      const std::size_t ib(arr.normals_offset[i]), ie(arr.normals_offset[i+1]);
+      e.demi_normals.reserve(ie-ib);
+      for (std::size_t j = ib; j < ie; ++j)
+        e.demi_normals.emplace_back(arr.normal_x[j],arr.normal_y[j],arr.normal_z[j]);
+      if (arr.hasEqvHKL()) {
+        e.eqv_hkl = decltype(e.eqv_hkl)(new short[3*(ie-ib)]);
+        std::copy(arr.eqv_hkl.begin()+3*ib,arr.eqv_hkl.begin()+3*ie,&e.eqv_hkl[0]);
       }
     }
+  });
+}
+
+struct NC::Info::HKLIndex {
+  //Maps packed (h,k,l) values, with the sign chosen so the first non-zero
+  //index is positive, to the index of the owning entry in the HKL list:
+  std::unordered_map<uint64_t,unsigned> map;
+  static bool pack( int h, int k, int l, uint64_t& key )
+  {
+    constexpr int smin = std::numeric_limits<short>::min();
+    constexpr int smax = std::numeric_limits<short>::max();
+    if ( h < smin || h > smax || k < smin || k > smax || l < smin || l > smax )
+      return false;
+    if ( h < 0 || ( h == 0 && ( k < 0 || ( k == 0 && l < 0 ) ) ) ) {
+      h = -h;
+      k = -k;
+      l = -l;
+    }
+    key = ( static_cast<uint64_t>(static_cast<uint16_t>(h)) << 32 )
+      | ( static_cast<uint64_t>(static_cast<uint16_t>(k)) << 16 )
+      | static_cast<uint64_t>(static_cast<uint16_t>(l));
+    return true;
+  }
+  void add( const short * eqv, std::size_t n, unsigned idx )
+  {
+    uint64_t key;
+    for ( std::size_t j = 0; j < n; ++j, eqv += 3 ) {
+      if ( pack( eqv[0], eqv[1], eqv[2], key ) )
+        map.emplace( key, idx );//keeps the first entry, like a linear search would
+    }
   }
-  return itE;
+};
+
+const NC::Info::HKLIndex& NC::Info::hklIndex() const
+{
+  std::call_once(m_hklindex_flag,[this]()
+  {
+    std::unique_ptr<HKLIndex> index = std::make_unique<HKLIndex>();
+    if (m_hklarrays) {
+      const HKLArrays& arr = *m_hklarrays;
+      index->map.reserve( arr.eqv_hkl.size() / 3 );
+      for ( std::size_t i = 0; i < arr.size(); ++i ) {
+        const std::size_t ib(arr.normals_offset[i]), ie(arr.normals_offset[i+1]);
+        index->add( &arr.eqv_hkl[0] + 3*ib, ie-ib, static_cast<unsigned>(i) );
+      }
+    } else {
+      for ( std::size_t i = 0; i < m_hkllist.size(); ++i ) {
+        const HKLInfo& e = m_hkllist[i];
+        nc_assert(e.eqv_hkl);
+        index->add( &e.eqv_hkl[0], e.multiplicity/2, static_cast<unsigned>(i) );
+      }
+    }
+    m_hklindex = std::move(index);
+  });
+  nc_assert(m_hklindex);
+  return *m_hklindex;
+}
+
+int NC::Info::searchExpandedHKLIdx( int h, int k, int l ) const
+{
+  uint64_t key;
+  if ( !HKLIndex::pack( h, k, l, key ) )
+    return -1;
+  const auto& map = hklIndex().map;
+  auto it = map.find( key );
+  return it == map.end() ? -1 : static_cast<int>( it->second );
+}
+
+NC::HKLList::const_iterator NC::Info::searchExpandedHKL(short h, short k, short l) const
+{
+  nc_assert_always(hasHKLInfo());
+  nc_assert_always(hasExpandedHKLInfo());
+  //The lookup itself only needs the index. The HKLList compatibility view is
+  //only expanded when returning an entry which the caller might dereference
+  //(expansion does not invalidate iterators, so end() is fine to return as-is):
+  const int idx = searchExpandedHKLIdx( h, k, l );
+  if ( idx < 0 )
+    return m_hkllist.end();
+  return hklBegin() + idx;
+}
+
+void NC::Info::searchExpandedHKLIndices( std::size_t n, const int * hkl, int * out_idx ) const
+{
+  nc_assert_always(hasHKLInfo());
+  nc_assert_always(hasExpandedHKLInfo());
+  for ( std::size_t i = 0; i < n; ++i, hkl += 3 )
+    out_idx[i] = searchExpandedHKLIdx( hkl[0], hkl[1], hkl[2] );
 }
 
 //TODO: why not always provide eqv_hkl from .ncmat factories and remove
@@ -517,7 +674,7 @@ double NC::Info::hklDMinVal() const
   nc_assert(hasHKLInfo());
   if (m_hkllist.empty())
     return kInfinity;
-  return hklLast()->dspacing;
+  return m_hkllist.back().dspacing;
 }
 
 double NC::Info::hklDMaxVal() const
@@ -525,7 +682,7 @@ double NC::Info::hklDMaxVal() const
   nc_assert(hasHKLInfo());
   if (m_hkllist.empty())
     return kInfinity;
-  return hklBegin()->dspacing;
+  return m_hkllist.front().dspacing;
 }
 
 double NC::Info::dspacingFromHKL( int h, int k, int l ) const
@@ -558,6 +715,8 @@ std::shared_ptr<const NC::SABData> NC::DI_ScatKnlDirect::ensureBuildThenReturnSA
   if ( ! m_sabdata ) {
     m_sabdata = buildSAB();
     nc_assert_always( !! m_sabdata );
+    //Share memory (and derived objects) with identical kernels from elsewhere:
+    m_sabdata = SAB::internSABData( std::move(m_sabdata) );
     if ( m_sabdata->temperature() != this->temperature() )
         NCRYSTAL_THROW(BadInput,"temperature info on SABData object provided by DI_ScatKnlDirect object"
                        " is different than temperature on DI_ScatKnlDirect object itself!");
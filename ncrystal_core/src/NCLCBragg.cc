@@ -28,6 +28,7 @@
 #include "NCrystal/internal/NCLatticeUtils.hh"
 #include "NCrystal/internal/NCOrientUtils.hh"
 #include "NCrystal/internal/NCPlaneProvider.hh"
+#include <iostream>
 
 namespace NCrystal{
 
@@ -35,7 +36,8 @@ namespace NCrystal{
 
     pimpl(LCBragg * lcbragg, Vector lcaxis, int mode,
           SCOrientation sco, const Info* cinfo, PlaneProvider * plane_provider,
-          double mosaicity, double delta_d, double prec,double ntrunc)
+          double mosaicity, double delta_d, double prec,double ntrunc, double xstab_prec,
+          int fixedrot_seed)
       : m_ekin_low(-1)
     {
       nc_assert_always(lcbragg&&cinfo);
@@ -67,6 +69,19 @@ namespace NCrystal{
 
         m_ekin_low = wl2ekin( m_lchelper->braggThreshold() );
 
+        if ( xstab_prec > 0.0 && m_lchelper->braggThreshold() > 0.0 ) {
+          //Tabulate down to 10% of the Bragg threshold, which covers the
+          //typical usage range while avoiding the explosion of Bragg edges at
+          //shorter wavelengths:
+          m_lctable = std::make_unique<LCXSTable>( *m_lchelper, xstab_prec,
+                                                   0.1 * m_lchelper->braggThreshold() );
+          if ( m_lctable->reachedMaxPoints() )
+            std::cout<<"NCrystal WARNING: LCBragg cross section table reached its maximum size before the requested"
+                     <<" precision (lctabprec="<<xstab_prec<<") was reached everywhere. Cross sections in the "
+                     <<m_lctable->nUntabulatedCells()<<" remaining regions will be evaluated directly (without"
+                     <<" the speedup of the table)."<<std::endl;
+        }
+
       } else {
         RCHolder<Scatter> scbragg(new SCBragg(cinfo,sco,mosaicity,delta_d,plane_provider,prec, ntrunc));
         if (mode>0) {
@@ -74,7 +89,10 @@ namespace NCrystal{
         } else {
           int nsample = -mode;
           nc_assert(nsample>0);
-          m_scmodel = new LCBraggRndmRot(scbragg.obj(), lcaxis_labframe, nsample);
+          if ( fixedrot_seed >= 0 )
+            m_scmodel = new LCBraggFixedRot(scbragg.obj(), lcaxis_labframe, nsample, static_cast<unsigned>(fixedrot_seed));
+          else
+            m_scmodel = new LCBraggRndmRot(scbragg.obj(), lcaxis_labframe, nsample);
         }
         lcbragg->registerSubCalc(m_scmodel.obj());
         nc_assert(m_scmodel->isSubCalc(scbragg.obj()));
@@ -92,9 +110,10 @@ namespace NCrystal{
 
     double m_ekin_low;
     std::unique_ptr<LCHelper> m_lchelper;
-    LCHelper::Cache m_lchcache;//TODO: do something more elaborate (or MT
-                               //safe?) than this? Caching the last N calls,
-                               //might speed up some scenarios.
+    std::unique_ptr<LCXSTable> m_lctable;
+    LCHelper::Cache m_lchcache;//Shared (not MT safe). Only used by
+                               //crossSection when there is no m_lctable, so
+                               //table-backed cross sections are const-safe.
     RCHolder<Scatter> m_scmodel;
   };
 
@@ -102,11 +121,12 @@ namespace NCrystal{
 
 NCrystal::LCBragg::LCBragg( const Info* ci, const SCOrientation& sco, double mosaicity,
                             const double (&lcaxis)[3], int mode, double delta_d, PlaneProvider * plane_provider,
-                            double prec, double ntrunc)
+                            double prec, double ntrunc, double xstab_prec, int fixedrot_seed)
   : Scatter("LCBragg"),
-    m_pimpl(new pimpl(this,asVect(lcaxis),mode,sco,ci,plane_provider,mosaicity,delta_d,prec,ntrunc))
+    m_pimpl(new pimpl(this,asVect(lcaxis),mode,sco,ci,plane_provider,mosaicity,delta_d,prec,ntrunc,xstab_prec,fixedrot_seed))
 {
   nc_assert_always(ci);
+  nc_assert_always(xstab_prec>=0.0);
   nc_assert_always(bool(m_pimpl->m_lchelper)!=bool(m_pimpl->m_scmodel.obj()));
   validate();
 }
@@ -152,7 +172,15 @@ double NCrystal::LCBragg::crossSection( double ekin,
     return 0.0;
 
   if (! m_pimpl->m_scmodel ) {
-    return m_pimpl->m_lchelper->crossSection( m_pimpl->m_lchcache, ekin2wl(ekin), asVect(indir) );
+    const double wl = ekin2wl(ekin);
+    double xs;
+    if ( m_pimpl->m_lctable ) {
+      if ( m_pimpl->m_lctable->lookup( wl, asVect(indir), xs ) )
+        return xs;
+      //Untabulated cell, use a local cache to avoid touching shared state:
+      return m_pimpl->m_lchelper->crossSectionNoCache( wl, asVect(indir) );
+    }
+    return m_pimpl->m_lchelper->crossSection( m_pimpl->m_lchcache, wl, asVect(indir) );
   } else {
     return m_pimpl->m_scmodel->crossSection(ekin,indir);
   }
@@ -20,10 +20,182 @@
 
 #include "NCrystal/internal/NCLCRefModels.hh"
 #include "NCrystal/internal/NCRandUtils.hh"
+#include "NCrystal/internal/NCSCBragg.hh"
+#include "NCrystal/internal/NCGaussMos.hh"
+#include "NCrystal/internal/NCRomberg.hh"
+#include <map>
+#include <iostream>
 
 namespace NC = NCrystal;
 
-NC::LCBraggRef::LCBraggRef(Scatter* scb, Vector lcaxis_lab, unsigned nsample)
+struct NC::LCBraggRef::PhiIntegrator {
+
+  //Averages the contributions of all demi-normals of an SCBragg object over
+  //rotations around the lcaxis. For a demi-normal n and neutron direction d,
+  //the cosine of the angle between d and the rotated normal is a+b*cos(phi),
+  //with a=dot(d,lcaxis)*dot(n,lcaxis) and b=|d_perp|*|n_perp|. Thus, only
+  //dot(n,lcaxis) matters, and demi-normals sharing |dot(n,lcaxis)| can be
+  //merged (flipping its sign simply swaps the roles of normal and
+  //anti-normal).
+
+  struct AxisProj {
+    double z;//|dot(n,lcaxis)|
+    double sz;//sqrt(1-z^2)
+    double mult;//number of demi-normals
+  };
+  struct Family {
+    double inv2d;
+    double xsfact;
+    std::vector<AxisProj> projs;
+  };
+  const GaussMos& gm;
+  std::vector<Family> families;//sorted by d-spacing, largest first
+  const unsigned nsample;//rotations used for families where integration fails
+
+  PhiIntegrator( const SCBragg& sc, const Vector& lcaxis, unsigned nsample_fallback )
+    : gm(sc.gaussMos()), nsample(nsample_fallback)
+  {
+    sc.visitReflectionFamilies([this,&lcaxis](double inv2d, double xsfact, const std::vector<Vector>& deminormals)
+    {
+      //Merge on |z| rounded to 1e-12, to avoid floating point issues:
+      std::map<int64_t,AxisProj> m;
+      for ( auto& dn : deminormals ) {
+        const double z = ncmin(1.0,ncabs(lcaxis.dot(dn)));
+        AxisProj& p = m[static_cast<int64_t>(z*1e12+0.5)];
+        if ( !p.mult ) {
+          p.z = z;
+          p.sz = std::sqrt(1.0-z*z);
+        }
+        p.mult += 1.0;
+      }
+      families.push_back({inv2d,xsfact,{}});
+      families.back().projs.reserve(m.size());
+      for ( auto& e : m )
+        families.back().projs.push_back(e.second);
+    });
+    nc_assert_always(std::is_sorted(families.begin(),families.end(),
+                                    [](const Family& f1, const Family& f2){ return f1.inv2d < f2.inv2d; }));
+  }
+
+  class Integrand : public Romberg {
+  public:
+    Integrand(const GaussMos& gm, GaussMos::InteractionPars& ip, double a, double b, double sign)
+      : m_gm(gm), m_ip(ip), m_a(a), m_b(b), m_sign(sign),
+        m_acc(ncclamp(gm.precision(),1e-7,1e-2)), m_converged(true) {}
+    virtual ~Integrand(){}
+    virtual double evalFunc(double phi) const
+    {
+      return m_gm.calcRawCrossSectionValue(m_ip,ncclamp(m_sign*(m_a+m_b*std::cos(phi)),-1.0,1.0));
+    }
+    virtual bool accept(unsigned, double prev_estimate, double estimate,double,double) const
+    {
+      return ncabs(estimate-prev_estimate) <= m_acc*ncabs(estimate);
+    }
+    virtual void convergenceError(double, double) const
+    {
+      //Near Bragg edges the integrand is nearly singular and convergence is
+      //slow. Flag the problem, so the caller can fall back to a rotation
+      //average rather than trusting the estimate:
+      m_converged = false;
+    }
+    bool converged() const { return m_converged; }
+  private:
+    const GaussMos& m_gm;
+    GaussMos::InteractionPars& m_ip;
+    const double m_a, m_b, m_sign;
+    const double m_acc;
+    mutable bool m_converged;
+  };
+
+  //Contribution of a single family. If use_romberg is false (or integration
+  //fails to converge), the contributions are instead averaged over nsample
+  //equally spaced rotations (the same as used by LCBraggRef without
+  //phi_analytic):
+  double familyCrossSection( const Family& fam, GaussMos::InteractionPars& ip,
+                             double c3, double s3, double wl, bool use_romberg, bool& converged ) const
+  {
+    //The anti-normal (normal) contributes only when the angle between
+    //indir and the normal is within trunc of pi/2-theta (pi/2+theta),
+    //corresponding to the following ranges of cos(angle):
+    const double trunc = gm.mosaicityTruncationAngle();
+    const double theta = std::asin(ncmin(1.0,wl*fam.inv2d));
+    const double xwin[2][2] = { { std::cos(ncmin(kPi,kPiHalf-theta+trunc)), std::cos(ncmax(0.0,kPiHalf-theta-trunc)) },
+                                { std::cos(ncmin(kPi,kPiHalf+theta+trunc)), std::cos(ncmax(0.0,kPiHalf+theta-trunc)) } };
+    const double dphi = k2Pi / nsample;
+    StableSum sumxs;
+    for ( auto& p : fam.projs ) {
+      const double a = c3 * p.z;
+      const double b = s3 * p.sz;
+      if ( b < 1e-10 ) {
+        //No dependency on rotation angle:
+        double xs = gm.calcRawCrossSectionValue(ip,ncclamp(a,-1.0,1.0))
+          + gm.calcRawCrossSectionValue(ip,ncclamp(-a,-1.0,1.0));
+        sumxs.add(p.mult*xs);
+        continue;
+      }
+      for ( unsigned k = 0; k < 2; ++k ) {
+        //Find phi range (in [0,pi]) where a+b*cos(phi) is within the window:
+        const double xlow = ncmax(xwin[k][0],a-b);
+        const double xhigh = ncmin(xwin[k][1],a+b);
+        if ( !(xlow<xhigh) )
+          continue;
+        const double philow = std::acos(ncclamp((xhigh-a)/b,-1.0,1.0));
+        const double phihigh = std::acos(ncclamp((xlow-a)/b,-1.0,1.0));
+        if ( !(philow<phihigh) )
+          continue;
+        Integrand integrand(gm,ip,a,b,(k==0?1.0:-1.0));
+        if ( use_romberg ) {
+          sumxs.add( p.mult * integrand.integrate(philow,phihigh) * kInvPi );
+          if ( !integrand.converged() ) {
+            converged = false;
+            return 0.0;
+          }
+          continue;
+        }
+        StableSum sumrot;
+        for ( unsigned i = 0; i < nsample; ++i ) {
+          const double phi = ncabs( i * dphi - kPi );
+          if ( phi >= philow && phi <= phihigh )
+            sumrot.add( integrand.evalFunc(phi) );
+        }
+        sumxs.add( p.mult * sumrot.sum() / nsample );
+      }
+    }
+    return sumxs.sum();
+  }
+
+  double crossSection( double wl, const Vector& indir, const Vector& lcaxis ) const
+  {
+    nc_assert(indir.isUnitVector());
+    const double c3 = ncclamp(lcaxis.dot(indir),-1.0,1.0);
+    const double s3 = std::sqrt(1.0-c3*c3);
+    const double inv2dcutoff = (1.0-2*std::numeric_limits<double>::epsilon())/wl;
+    StableSum sumxs;
+    GaussMos::InteractionPars ip;
+    for ( auto& fam : families ) {
+      if ( fam.inv2d >= inv2dcutoff )
+        break;//stop here, no more families fulfill wl<2d requirement.
+      ip.set(wl,fam.inv2d,fam.xsfact);
+      bool converged = true;
+      double xs = familyCrossSection(fam,ip,c3,s3,wl,true,converged);
+      if ( !converged ) {
+        static bool first = true;
+        if (first) {
+          first = false;
+          std::cout<<"NCrystal WARNING: Romberg integration over rotation angles did not converge in LCBraggRef"
+            " (this can happen very close to Bragg edges). Cross sections of the affected reflection families are"
+            " instead averaged over "<<nsample<<" rotations. Further warnings of this type will not be"
+            " emitted."<<std::endl;
+        }
+        xs = familyCrossSection(fam,ip,c3,s3,wl,false,converged);
+      }
+      sumxs.add(xs);
+    }
+    return sumxs.sum();
+  }
+};
+
+NC::LCBraggRef::LCBraggRef(Scatter* scb, Vector lcaxis_lab, unsigned nsample, bool phi_analytic)
   : Scatter("LCBraggRef"),
     m_sc(scb),
     m_lcaxislab(lcaxis_lab.unit()),
@@ -33,6 +205,9 @@ NC::LCBraggRef::LCBraggRef(Scatter* scb, Vector lcaxis_lab, unsigned nsample)
   registerSubCalc(scb);
   while (!isPrime(m_nsampleprime))
     ++m_nsampleprime;
+  const SCBragg * scbragg = phi_analytic ? dynamic_cast<const SCBragg*>(scb) : nullptr;
+  if (scbragg)
+    m_phiint = std::make_unique<PhiIntegrator>(*scbragg,m_lcaxislab,m_nsampleprime);
 }
 
 NC::LCBraggRef::~LCBraggRef()
@@ -47,6 +222,11 @@ void NC::LCBraggRef::domain(double& ekin_low, double& ekin_high) const
 double NC::LCBraggRef::crossSection( double ekin, const double (&indirraw)[3] ) const
 {
   Vector indir = asVect(indirraw).unit();
+  if (m_phiint) {
+    double ekin_low, ekin_high;
+    m_sc->domain(ekin_low,ekin_high);
+    return ekin > ekin_low ? m_phiint->crossSection(ekin2wl(ekin),indir,m_lcaxislab) : 0.0;
+  }
   Vector lccross = m_lcaxislab.cross(indir);
   double lcdot = m_lcaxislab.dot(indir);
   StableSum sumxs;
@@ -172,3 +352,89 @@ void NC::LCBraggRndmRot::generateScattering( double ekin,
                                  NC_VECTOR_CAST(outdir_rot), delta_ekin);
   asVect(outdir) = phirot.rotateVectorAroundAxis( outdir_rot, m_lcaxislab, true/*reverse*/);
 }
+
+NC::LCBraggFixedRot::LCBraggFixedRot(Scatter* scb, Vector lcaxis_lab, unsigned nsample, unsigned seed)
+  : Scatter("LCBraggFixedRot"),
+    m_sc(scb),
+    m_lcaxislab(lcaxis_lab.unit())
+{
+  registerSubCalc(scb);
+  nc_assert_always(nsample>0);
+  //Golden angle sequence (low discrepancy for any nsample), with a starting
+  //point derived from the seed via another irrational number:
+  const double golden_conj = 0.5*(std::sqrt(5.0)-1.0);
+  double u = seed * kSqrt2;
+  u -= std::floor(u);
+  m_rotations.reserve(nsample);
+  for (unsigned i = 0; i<nsample; ++i) {
+    m_rotations.emplace_back( ncclamp( u * k2Pi - kPi, -kPi, kPi ) );
+    u += golden_conj;
+    if ( u >= 1.0 )
+      u -= 1.0;
+  }
+}
+
+NC::LCBraggFixedRot::~LCBraggFixedRot()
+{
+}
+
+void NC::LCBraggFixedRot::domain(double& ekin_low, double& ekin_high) const
+{
+  return m_sc->domain(ekin_low,ekin_high);
+}
+
+double NC::LCBraggFixedRot::crossSection( double ekin, const double (&indirraw)[3] ) const
+{
+  Vector indir = asVect(indirraw).unit();
+  Vector lccross = m_lcaxislab.cross(indir);
+  double lcdot = m_lcaxislab.dot(indir);
+  StableSum sumxs;
+  for ( auto& phirot : m_rotations ) {
+    Vector v = phirot.rotateVectorAroundAxis( indir, m_lcaxislab, lccross, lcdot );
+    sumxs.add(m_sc->crossSection(ekin,NC_CVECTOR_CAST(v)));
+  }
+  return sumxs.sum()/m_rotations.size();
+}
+
+void NC::LCBraggFixedRot::generateScattering( double ekin,
+                                              const double (&indirraw)[3],
+                                              double (&outdir)[3],
+                                              double& delta_ekin ) const
+{
+  delta_ekin = 0;
+
+  const double xstot = crossSection(ekin,indirraw) * m_rotations.size();
+  Vector indir = asVect(indirraw).unit();
+  if (!xstot) {
+    //no xs, do nothing.
+    asVect(outdir) = indir;
+    return;
+  }
+
+  //Select one phi rotation at random, weighted by its cross-section. Since
+  //the rotations are fixed, the cross-sections are simply recomputed (rather
+  //than stored in the first pass), stopping at the selected rotation:
+  Vector lccross = m_lcaxislab.cross(indir);
+  double lcdot = m_lcaxislab.dot(indir);
+  const double xsselect = getRNG()->generate() * xstot;
+  const PhiRot * phirot = nullptr;
+  double xscommul = 0.0;
+  for ( auto& pr : m_rotations ) {
+    Vector v = pr.rotateVectorAroundAxis( indir, m_lcaxislab, lccross, lcdot );
+    const double xs = m_sc->crossSection(ekin,NC_CVECTOR_CAST(v));
+    if ( xs > 0.0 ) {
+      phirot = &pr;//last rotation with non-zero xs guards against rounding issues
+      xscommul += xs;
+      if ( xscommul >= xsselect )
+        break;
+    }
+  }
+  nc_assert_always(phirot!=nullptr);
+
+  //Scatter!
+  Vector v = phirot->rotateVectorAroundAxis( indir, m_lcaxislab);
+  Vector outdir_rot;
+  m_sc->generateScattering(ekin, NC_CVECTOR_CAST(v),
+                                 NC_VECTOR_CAST(outdir_rot), delta_ekin);
+  asVect(outdir) = phirot->rotateVectorAroundAxis( outdir_rot, m_lcaxislab, true/*reverse*/);
+}
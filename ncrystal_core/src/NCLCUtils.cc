@@ -29,6 +29,8 @@
 #include <cstring>
 #include <iostream>
 #include <functional>//std::greater
+#include <deque>
+#include <limits>
 
 namespace NC = NCrystal;
 
@@ -341,7 +343,11 @@ bool NC::LCHelper::isValid(NC::LCHelper::Cache& cache, double wl, const NC::Vect
 void NC::LCHelper::ensureValid(NC::LCHelper::Cache& cache, double wl, const NC::Vector& indir) const
 {
   nc_assert(indir.isUnitVector()&&wl>0.0);
-  double c3 = m_lcaxislab.dot(indir);
+  ensureValid(cache,wl,m_lcaxislab.dot(indir));
+}
+
+void NC::LCHelper::ensureValid(NC::LCHelper::Cache& cache, double wl, double c3) const
+{
   nc_assert(wl>=0&&wl<1e7&&c3>=-1.0&&c3<=1.0);
   uint64_t discrwl = LCdiscretizeValue(wl);
   uint64_t discrc3 = LCdiscretizeValue(ncabs(c3));
@@ -452,6 +458,12 @@ double NC::LCHelper::crossSection( NC::LCHelper::Cache& cache, double wl, const
   return cache.m_roixs_commul.empty() ? 0.0 : (m_xsfact * cache.m_roixs_commul.back());
 }
 
+double NC::LCHelper::crossSection( NC::LCHelper::Cache& cache, double wl, double c3 ) const
+{
+  ensureValid(cache,wl,c3);
+  return cache.m_roixs_commul.empty() ? 0.0 : (m_xsfact * cache.m_roixs_commul.back());
+}
+
 void NC::LCHelper::Cache::reset()
 {
   //same result as Cache() constructor
@@ -782,3 +794,308 @@ void NC::LCStdFrame::genScat( RandomBase * rand,
   Vector indir_stdframe(-neutron.s3,0.,-neutron.c3);
   m_gm.genScat( rand, scatcache, neutron.wl, indir_stdframe, outdir );
 }
+
+NC::LCXSTable::LCXSTable( const LCHelper& lch, double prec, double wlmin, std::size_t maxpoints )
+  : m_lcaxislab(lch.lcaxisLab()),
+    m_nth(0),
+    m_thmax(0.0),
+    m_dth(0.0),
+    m_nuntabulated(0),
+    m_capped(false)
+{
+  const double wlmax = lch.braggThreshold();
+  nc_assert_always(prec>0.0&&prec<1.0);
+  nc_assert_always(wlmin>0.0&&wlmin<wlmax);
+  nc_assert_always(maxpoints>=1000);
+
+  LCHelper::Cache cache;
+  auto evalXS = [&lch,&cache](double wl, double theta)
+  {
+    return lch.crossSection( cache, wl, cos_mpi2pi2(theta) );
+  };
+
+  //Base cells have sizes equal to the mosaicity, which is the scale of the
+  //typical structures, both in wavelength (relative) and angle:
+  const double mos = lch.gaussMos().mosaicityFWHM();
+  const double truncangle = lch.gaussMos().mosaicityTruncationAngle();
+
+  //Angular range stops just short of pi/2, since the numerical integrations in
+  //LCHelper are fragile for neutrons exactly perpendicular to the lcaxis (a
+  //measure-zero case, which will be handled by constant extrapolation):
+  m_thmax = kPiHalf * ( 1.0 - 1e-6 );
+  m_nth = static_cast<unsigned>( ncmax( 4.0, std::ceil( m_thmax / mos ) ) );
+  m_dth = m_thmax / m_nth;
+
+  //Bragg edges (wl=2*dspacing) must fall on cell boundaries, since
+  //cross-sections are discontinuous there. Cross-sections inside a segment
+  //between two edges are always evaluated slightly inside the segment:
+  VectD edges;
+  edges.push_back(wlmin);
+  for ( auto& ps : lch.planeSets() ) {
+    if ( ps.twodsp <= wlmin )
+      break;//sorted by dspacing, largest first.
+    if ( ps.twodsp < wlmax )
+      edges.push_back(ps.twodsp);
+  }
+  edges.push_back(wlmax);
+  std::sort(edges.begin(),edges.end());
+  edges.erase(std::unique(edges.begin(),edges.end()),edges.end());
+
+  //Below a Bragg edge, the planes of the edge are near backscattering and the
+  //cross-section has structure on all scales (with a singularity at the
+  //edge). That only affects angles close to those of the plane normals, so
+  //for the last column of cells in each segment we keep the (folded) normal
+  //angles of the edge planes, in order to be able to force refinement:
+  struct Column { double wlevalmin, wlevalmax; VectD edgealphas; };
+  std::vector<Column> columns;
+  const double edgeoffset = 1e-9;
+  m_colwl.push_back(edges.front());
+  for ( std::size_t iseg = 0; iseg+1 < edges.size(); ++iseg ) {
+    const double a(edges[iseg]), b(edges[iseg+1]);
+    VectD edgealphas;
+    for ( auto& ps : lch.planeSets() ) {
+      if ( ncabs( ps.twodsp - b ) <= 1e-12 * b ) {
+        const double alpha = std::atan2(ps.sinalpha,ps.cosalpha);
+        edgealphas.push_back( ncmin( alpha, kPi - alpha ) );
+      }
+    }
+    const unsigned n = static_cast<unsigned>( ncmax( 1.0, std::ceil( std::log(b/a) / mos ) ) );
+    for ( unsigned i = 1; i <= n; ++i ) {
+      m_colwl.push_back( i == n ? b : a * std::pow( b/a, double(i)/n ) );
+      columns.push_back( Column{ a * ( 1.0 + edgeoffset ), b * ( 1.0 - edgeoffset ),
+                                 i == n ? edgealphas : VectD() } );
+    }
+  }
+  const std::size_t ncols = columns.size();
+  nc_assert_always( m_colwl.size() == ncols + 1 );
+
+  //Pending cells, with their lattice of exact values:
+  struct Cell {
+    uint32_t node, col;
+    double wl0, wl1, th0, th1;
+    double x[5][5];
+  };
+  auto evalLattice = [&evalXS,&columns]( Cell& c, bool skip_even_wl, bool skip_even_th )
+  {
+    const Column& col = columns.at(c.col);
+    for ( unsigned i = 0; i < 5; ++i ) {
+      if ( skip_even_wl && i%2==0 )
+        continue;
+      const double wl = ncclamp( c.wl0 + 0.25*i*(c.wl1-c.wl0), col.wlevalmin, col.wlevalmax );
+      for ( unsigned j = 0; j < 5; ++j ) {
+        if ( skip_even_th && j%2==0 )
+          continue;
+        c.x[i][j] = evalXS( wl, c.th0 + 0.25*j*(c.th1-c.th0) );
+      }
+    }
+  };
+
+  std::deque<Cell> pending;
+  m_nodes.resize( ncols * m_nth, Node{0,Untabulated} );
+  StableSum xssum;
+  for ( std::size_t icol = 0; icol < ncols; ++icol ) {
+    for ( unsigned j = 0; j < m_nth; ++j ) {
+      pending.emplace_back();
+      Cell& c = pending.back();
+      c.node = static_cast<uint32_t>( icol * m_nth + j );
+      c.col = static_cast<uint32_t>( icol );
+      c.wl0 = m_colwl[icol];
+      c.wl1 = m_colwl[icol+1];
+      c.th0 = j * m_dth;
+      c.th1 = ( j+1 == m_nth ? m_thmax : (j+1) * m_dth );
+      evalLattice( c, false, false );
+      for ( auto& row : c.x )
+        for ( auto& v : row )
+          xssum.add(v);
+    }
+  }
+
+  //Tolerance is relative, except for values which are negligible compared to
+  //the typical cross-section (the maximum is not used as reference, since it
+  //is dominated by the near-singular values close to the Bragg edges):
+  const double xsnegligible = 0.1 * xssum.sum() / ( pending.size() * 25 );
+  auto acceptInterp = [xsnegligible,prec](double exact, double interp)
+  {
+    return ncabs(exact-interp) <= prec * ncmax( ncabs(exact), xsnegligible );
+  };
+
+  const double minrelwlstep = 1e-4;
+  const double minthstep = 1e-4;
+  const double minreledgestep = 3e-4;
+  while ( !pending.empty() ) {
+    //Process breadth-first, so that in case maxpoints is reached, it is the
+    //finest structures which are left untabulated:
+    Cell c = pending.front();
+    pending.pop_front();
+    nc_assert( m_nodes.at(c.node).type == Untabulated );
+
+    //Compare lattice values with interpolation on the 3x3 sub-lattice,
+    //keeping track of whether failures suggest a split in wavelength or
+    //angle:
+    double errwl(0.0), errth(0.0);
+    bool ok = true;
+    for ( unsigned i = 0; i < 5; ++i ) {
+      for ( unsigned j = 0; j < 5; ++j ) {
+        if ( i%2==0 && j%2==0 )
+          continue;
+        double interp;
+        if ( i%2==0 )
+          interp = 0.5 * ( c.x[i][j-1] + c.x[i][j+1] );
+        else if ( j%2==0 )
+          interp = 0.5 * ( c.x[i-1][j] + c.x[i+1][j] );
+        else
+          interp = 0.25 * ( c.x[i-1][j-1] + c.x[i-1][j+1] + c.x[i+1][j-1] + c.x[i+1][j+1] );
+        if ( acceptInterp( c.x[i][j], interp ) )
+          continue;
+        ok = false;
+        const double err = ncabs( c.x[i][j] - interp );
+        if ( j%2==0 ) {
+          errwl = ncmax( errwl, err );
+        } else if ( i%2==0 ) {
+          errth = ncmax( errth, err );
+        } else {
+          errwl = ncmax( errwl, 0.5*err );
+          errth = ncmax( errth, 0.5*err );
+        }
+      }
+    }
+
+    //Cells just below a Bragg edge and close to the angles of the edge planes
+    //are refined in wavelength until they are narrow, and then left
+    //untabulated:
+    const Column& col = columns.at(c.col);
+    if ( !col.edgealphas.empty() && c.wl1 == m_colwl[c.col+1] ) {
+      const double conehalfangle = std::acos( ncmin( 1.0, c.wl0 / m_colwl[c.col+1] ) );
+      const double band = conehalfangle + truncangle + mos;
+      bool nearedge = false;
+      for ( auto alpha : col.edgealphas ) {
+        if ( c.th1 > alpha - band && c.th0 < alpha + band ) {
+          nearedge = true;
+          break;
+        }
+      }
+      if ( nearedge ) {
+        if ( c.wl1 - c.wl0 <= minreledgestep * c.wl0 ) {
+          ++m_nuntabulated;
+          continue;
+        }
+        ok = false;
+        errwl = kInfinity;
+      }
+    }
+
+    if ( ok ) {
+      Node& node = m_nodes.at(c.node);
+      node.index = static_cast<uint32_t>( m_vals.size() );
+      node.type = Tabulated;
+      for ( auto& row : c.x )
+        for ( auto& v : row )
+          m_vals.push_back( static_cast<float>(v) );
+      continue;
+    }
+
+    const bool can_split_wl = c.wl1 - c.wl0 > 2.0 * minrelwlstep * c.wl0;
+    const bool can_split_th = c.th1 - c.th0 > 2.0 * minthstep;
+    if ( !can_split_wl && !can_split_th ) {
+      ++m_nuntabulated;
+      continue;
+    }
+    if ( m_capped || m_vals.size() + 25 * ( pending.size() + 2 ) > maxpoints ) {
+      m_capped = true;
+      ++m_nuntabulated;
+      continue;
+    }
+    const bool split_wl = can_split_wl && ( errwl >= errth || !can_split_th );
+    nc_assert_always( m_nodes.size() + 2 < std::numeric_limits<uint32_t>::max() );
+    const uint32_t ichild = static_cast<uint32_t>( m_nodes.size() );
+    m_nodes.at(c.node) = Node{ ichild, split_wl ? SplitWL : SplitTheta };
+    m_nodes.push_back( Node{0,Untabulated} );
+    m_nodes.push_back( Node{0,Untabulated} );
+
+    //The children reuse half of the lattice values of the parent:
+    Cell c0(c), c1(c);
+    c0.node = ichild;
+    c1.node = ichild + 1;
+    if ( split_wl ) {
+      c0.wl1 = c1.wl0 = 0.5 * ( c.wl0 + c.wl1 );
+      for ( unsigned i = 0; i < 3; ++i ) {
+        for ( unsigned j = 0; j < 5; ++j ) {
+          c0.x[2*i][j] = c.x[i][j];
+          c1.x[2*i][j] = c.x[i+2][j];
+        }
+      }
+    } else {
+      c0.th1 = c1.th0 = 0.5 * ( c.th0 + c.th1 );
+      for ( unsigned i = 0; i < 5; ++i ) {
+        for ( unsigned j = 0; j < 3; ++j ) {
+          c0.x[i][2*j] = c.x[i][j];
+          c1.x[i][2*j] = c.x[i][j+2];
+        }
+      }
+    }
+    evalLattice( c0, split_wl, !split_wl );
+    evalLattice( c1, split_wl, !split_wl );
+    pending.push_back( c0 );
+    pending.push_back( c1 );
+  }
+  m_nodes.shrink_to_fit();
+  m_vals.shrink_to_fit();
+}
+
+NC::LCXSTable::~LCXSTable()
+{
+}
+
+bool NC::LCXSTable::lookup( double wl, double c3, double& xs ) const
+{
+  if ( !coversWavelength(wl) )
+    return false;
+  if ( wl >= m_colwl.back() ) {
+    xs = 0.0;//above Bragg threshold
+    return true;
+  }
+  const std::size_t icol = ( std::upper_bound( m_colwl.begin(), m_colwl.end(), wl ) - m_colwl.begin() ) - 1;
+  nc_assert( icol + 1 < m_colwl.size() );
+  const double th = ncmin( std::acos( ncmin( 1.0, ncabs(c3) ) ), m_thmax );
+  const unsigned j = ncmin( m_nth - 1, static_cast<unsigned>( th / m_dth ) );
+
+  //Descend to the cell containing the point (must split exactly as in the
+  //constructor):
+  double wl0(m_colwl[icol]), wl1(m_colwl[icol+1]);
+  double th0( j * m_dth ), th1( j+1 == m_nth ? m_thmax : (j+1) * m_dth );
+  const Node * node = &m_nodes[ icol * m_nth + j ];
+  while ( node->type == SplitWL || node->type == SplitTheta ) {
+    if ( node->type == SplitWL ) {
+      const double mid = 0.5 * ( wl0 + wl1 );
+      if ( wl < mid ) {
+        wl1 = mid;
+        node = &m_nodes[node->index];
+      } else {
+        wl0 = mid;
+        node = &m_nodes[node->index+1];
+      }
+    } else {
+      const double mid = 0.5 * ( th0 + th1 );
+      if ( th < mid ) {
+        th1 = mid;
+        node = &m_nodes[node->index];
+      } else {
+        th0 = mid;
+        node = &m_nodes[node->index+1];
+      }
+    }
+  }
+  if ( node->type == Untabulated )
+    return false;
+
+  //Bilinear interpolation in the relevant part of the 5x5 lattice:
+  double u = 4.0 * ( wl - wl0 ) / ( wl1 - wl0 );
+  double v = 4.0 * ( th - th0 ) / ( th1 - th0 );
+  const unsigned iu = static_cast<unsigned>( ncclamp( u, 0.0, 3.0 ) );
+  const unsigned iv = static_cast<unsigned>( ncclamp( v, 0.0, 3.0 ) );
+  u -= iu;
+  v -= iv;
+  const float * x = &m_vals[ node->index + 5*iu + iv ];
+  xs = ( 1.0 - u ) * ( ( 1.0 - v ) * x[0] + v * x[1] ) + u * ( ( 1.0 - v ) * x[5] + v * x[6] );
+  return true;
+}
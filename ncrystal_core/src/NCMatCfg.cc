@@ -98,10 +98,17 @@ struct NC::MatCfg::Impl : public NC::RCBase {
                     PAR_infofactory,
                     PAR_lcaxis,
                     PAR_lcmode,
+                    PAR_lcrotseed,
+                    PAR_lctabprec,
                     PAR_mos,
                     PAR_mosprec,
                     PAR_overridefileext,
                     PAR_packfact,
+                    PAR_perf,
+                    PAR_sabalphatab,
+                    PAR_sabegridtol,
+                    PAR_sabfloat,
+                    PAR_sabtempinterp,
                     PAR_scatfactory,
                     PAR_sccutoff,
                     PAR_temp,
@@ -492,6 +499,26 @@ struct NC::MatCfg::Impl : public NC::RCBase {
     return vt ? vt->value : code_default_val;
   }
 
+  //Fallback values of the parameters which are affected by the "perf"
+  //parameter (keep in sync with documentation in NCMatCfg.hh):
+  struct PerfLevel {
+    const char * name;
+    int vdoslux;
+    double mosprec;
+    double sccutoff;
+    double sabegridtol;
+  };
+  static const PerfLevel perflevels[4];
+  const PerfLevel& getPerfLevel() const;
+
+  template <class ValType>
+  typename ValType::value_type getValPerfFallback(PARAMETERS par, typename ValType::value_type PerfLevel::* fallback) const
+  {
+    nc_assert( ValType::value_type_enum == partypes[par] );
+    const ValType * vt = getValType<ValType>(par);
+    return vt ? vt->value : getPerfLevel().*fallback;
+  }
+
   template <class ValType>
   const typename ValType::value_type& getValNoFallback(PARAMETERS par) const
   {
@@ -681,6 +708,7 @@ namespace NCrystal {
   static const std::string s_matcfg_str_empty = std::string();
   static const std::string s_matcfg_str_auto = std::string("auto");
   static const std::string s_matcfg_str_none = std::string("none");
+  static const std::string s_matcfg_str_default = std::string("default");
 
   //Important!: Keep the following two lists ordered (parnames sorted
   //alphabetically) and synchronised between themselves as well as the
@@ -698,10 +726,17 @@ namespace NCrystal {
                                                    "infofactory",
                                                    "lcaxis",
                                                    "lcmode",
+                                                   "lcrotseed",
+                                                   "lctabprec",
                                                    "mos",
                                                    "mosprec",
                                                    "overridefileext",
                                                    "packfact",
+                                                   "perf",
+                                                   "sabalphatab",
+                                                   "sabegridtol",
+                                                   "sabfloat",
+                                                   "sabtempinterp",
                                                    "scatfactory",
                                                    "sccutoff",
                                                    "temp",
@@ -719,14 +754,38 @@ namespace NCrystal {
                                                              VALTYPE_STR,
                                                              VALTYPE_VECTOR,
                                                              VALTYPE_INT,
+                                                             VALTYPE_INT,
+                                                             VALTYPE_DBL,
                                                              VALTYPE_DBL,
                                                              VALTYPE_DBL,
                                                              VALTYPE_STR,
                                                              VALTYPE_DBL,
                                                              VALTYPE_STR,
+                                                             VALTYPE_INT,
+                                                             VALTYPE_DBL,
+                                                             VALTYPE_INT,
+                                                             VALTYPE_DBL,
+                                                             VALTYPE_STR,
                                                              VALTYPE_DBL,
                                                              VALTYPE_DBL,
                                                              VALTYPE_INT };
+  const MatCfg::Impl::PerfLevel MatCfg::Impl::perflevels[4] = {
+    //name,       vdoslux, mosprec, sccutoff, sabegridtol
+    { "reference",      5,    1e-6,      0.0,         0.0 },
+    { "default",        3,    1e-3,      0.4,         0.0 },
+    { "fast",           2,    1e-2,      0.4,        1e-3 },
+    { "fastest",        1,    3e-2,      0.5,        1e-2 } };
+
+  const MatCfg::Impl::PerfLevel& MatCfg::Impl::getPerfLevel() const
+  {
+    const std::string& pn = getVal<ValStr>(PAR_perf,s_matcfg_str_default);
+    for ( auto& pl : perflevels )
+      if ( pn == pl.name )
+        return pl;
+    NCRYSTAL_THROW2(BadInput,"Invalid perf value specified: \""<<pn<<"\" (must be one of \"reference\","
+                    " \"default\", \"fast\" or \"fastest\")");
+  }
+
   struct MatCfg::Impl::SpyDisabler {
     //swaps spies with empty list (disabling spying) and swaps back in destructor
     SpyDisabler(std::vector<AccessSpy*>& spies)
@@ -820,6 +879,8 @@ void NC::MatCfg::checkConsistency() const
 {
   Impl::SpyDisabler nospy(m_impl->m_spies);//disable any spies during invocation of this method
 
+  m_impl->getPerfLevel();//throws BadInput in case of invalid perf value
+
   const double parval_temp = get_temp();
   const double parval_dcutoff = get_dcutoff();
   const double parval_dcutoffup = get_dcutoffup();
@@ -845,6 +906,11 @@ void NC::MatCfg::checkConsistency() const
   const double parval_mosprec = get_mosprec();
   if ( ! (valueInInterval(0.9999e-7,0.10000001,parval_mosprec) ) )
     NCRYSTAL_THROW(BadInput,"mosprec must be in the range [1e-7,1e-1].");
+  const double parval_lctabprec = get_lctabprec();
+  if ( parval_lctabprec!=0.0 && ! (valueInInterval(0.9999e-5,0.10000001,parval_lctabprec) ) )
+    NCRYSTAL_THROW(BadInput,"lctabprec must be 0 or in the range [1e-5,1e-1].");
+  if ( get_lcrotseed() < -1 )
+    NCRYSTAL_THROW(BadInput,"lcrotseed must be -1 or >=0.");
 
   //inelas:
   std::string parval_inelas = get_inelas();
@@ -927,6 +993,30 @@ void NC::MatCfg::checkConsistency() const
                     <<parval_vdoslux<<" (must be integer from 0 to 5)");
   }
 
+  const int parval_sabfloat = get_sabfloat();
+  if ( parval_sabfloat < 0 || parval_sabfloat > 2 ) {
+    NCRYSTAL_THROW2(BadInput, "Specified invalid sabfloat value of "
+                    <<parval_sabfloat<<" (must be integer from 0 to 2)");
+  }
+
+  const double parval_sabegridtol = get_sabegridtol();
+  if ( !(parval_sabegridtol>=0.0) || !(parval_sabegridtol<=0.1) ) {
+    NCRYSTAL_THROW2(BadInput, "Specified invalid sabegridtol value of "
+                    <<parval_sabegridtol<<" (must be 0 or a positive number not larger than 0.1)");
+  }
+
+  const double parval_sabtempinterp = get_sabtempinterp();
+  if ( !(parval_sabtempinterp>=0.0) || !(parval_sabtempinterp<=0.1) ) {
+    NCRYSTAL_THROW2(BadInput, "Specified invalid sabtempinterp value of "
+                    <<parval_sabtempinterp<<" (must be 0 or a positive number not larger than 0.1)");
+  }
+
+  const int parval_sabalphatab = get_sabalphatab();
+  if ( parval_sabalphatab != 0 && ( parval_sabalphatab < 128 || parval_sabalphatab > 16384 ) ) {
+    NCRYSTAL_THROW2(BadInput, "Specified invalid sabalphatab value of "
+                    <<parval_sabalphatab<<" (must be 0 or integer from 128 to 16384)");
+  }
+
 }
 
 void NC::MatCfg::getCacheSignature(std::string& out, const std::set<std::string>& pns) const
@@ -1279,8 +1369,8 @@ double NC::MatCfg::get_dcutoff() const { return m_impl->getVal<Impl::ValDbl>(Imp
 double NC::MatCfg::get_dcutoffup() const { return m_impl->getVal<Impl::ValDbl>(Impl::PAR_dcutoffup,kInfinity); }
 double NC::MatCfg::get_packfact() const { return m_impl->getVal<Impl::ValDbl>(Impl::PAR_packfact,1.0); }
 double NC::MatCfg::get_mos() const { return m_impl->getValNoFallback<Impl::ValDbl>(Impl::PAR_mos); }
-double NC::MatCfg::get_mosprec() const { return m_impl->getVal<Impl::ValDbl>(Impl::PAR_mosprec,1e-3); }
-double NC::MatCfg::get_sccutoff() const { return m_impl->getVal<Impl::ValDbl>(Impl::PAR_sccutoff,0.4); }
+double NC::MatCfg::get_mosprec() const { return m_impl->getValPerfFallback<Impl::ValDbl>(Impl::PAR_mosprec,&Impl::PerfLevel::mosprec); }
+double NC::MatCfg::get_sccutoff() const { return m_impl->getValPerfFallback<Impl::ValDbl>(Impl::PAR_sccutoff,&Impl::PerfLevel::sccutoff); }
 double NC::MatCfg::get_dirtol() const { return m_impl->getVal<Impl::ValDbl>(Impl::PAR_dirtol,1e-4); }
 bool NC::MatCfg::get_coh_elas() const { return m_impl->getVal<Impl::ValBool>(Impl::PAR_coh_elas,true); }
 bool NC::MatCfg::get_incoh_elas() const { return m_impl->getVal<Impl::ValBool>(Impl::PAR_incoh_elas,true); }
@@ -1311,8 +1401,22 @@ void NC::MatCfg::set_scatfactory( const std::string& v ) { cow(); m_impl->setVal
 void NC::MatCfg::set_absnfactory( const std::string& v ) { cow(); m_impl->setVal<Impl::ValStr>(Impl::PAR_absnfactory,v); }
 void NC::MatCfg::set_lcmode( int v ) { cow(); m_impl->setVal<Impl::ValInt>(Impl::PAR_lcmode,v); }
 int NC::MatCfg::get_lcmode() const { return m_impl->getVal<Impl::ValInt>(Impl::PAR_lcmode,0); }
+void NC::MatCfg::set_lcrotseed( int v ) { cow(); m_impl->setVal<Impl::ValInt>(Impl::PAR_lcrotseed,v); }
+int NC::MatCfg::get_lcrotseed() const { return m_impl->getVal<Impl::ValInt>(Impl::PAR_lcrotseed,-1); }
+void NC::MatCfg::set_lctabprec( double v ) { cow(); m_impl->setVal<Impl::ValDbl>(Impl::PAR_lctabprec,v); }
+double NC::MatCfg::get_lctabprec() const { return m_impl->getVal<Impl::ValDbl>(Impl::PAR_lctabprec,0.0); }
 void NC::MatCfg::set_vdoslux( int v ) { cow(); m_impl->setVal<Impl::ValInt>(Impl::PAR_vdoslux,v); }
-int NC::MatCfg::get_vdoslux() const { return m_impl->getVal<Impl::ValInt>(Impl::PAR_vdoslux,3); }
+int NC::MatCfg::get_vdoslux() const { return m_impl->getValPerfFallback<Impl::ValInt>(Impl::PAR_vdoslux,&Impl::PerfLevel::vdoslux); }
+void NC::MatCfg::set_sabfloat( int v ) { cow(); m_impl->setVal<Impl::ValInt>(Impl::PAR_sabfloat,v); }
+int NC::MatCfg::get_sabfloat() const { return m_impl->getVal<Impl::ValInt>(Impl::PAR_sabfloat,0); }
+void NC::MatCfg::set_sabegridtol( double v ) { cow(); m_impl->setVal<Impl::ValDbl>(Impl::PAR_sabegridtol,v); }
+double NC::MatCfg::get_sabegridtol() const { return m_impl->getValPerfFallback<Impl::ValDbl>(Impl::PAR_sabegridtol,&Impl::PerfLevel::sabegridtol); }
+void NC::MatCfg::set_sabtempinterp( double v ) { cow(); m_impl->setVal<Impl::ValDbl>(Impl::PAR_sabtempinterp,v); }
+double NC::MatCfg::get_sabtempinterp() const { return m_impl->getVal<Impl::ValDbl>(Impl::PAR_sabtempinterp,0.0); }
+void NC::MatCfg::set_sabalphatab( int v ) { cow(); m_impl->setVal<Impl::ValInt>(Impl::PAR_sabalphatab,v); }
+int NC::MatCfg::get_sabalphatab() const { return m_impl->getVal<Impl::ValInt>(Impl::PAR_sabalphatab,0); }
+void NC::MatCfg::set_perf( const std::string& v ) { cow(); m_impl->setVal<Impl::ValStr>(Impl::PAR_perf,v); }
+const std::string& NC::MatCfg::get_perf() const { return m_impl->getVal<Impl::ValStr>(Impl::PAR_perf,s_matcfg_str_default); }
 
 const std::string& NC::MatCfg::get_atomdb() const {
   const Impl::ValAtomDB * vt = m_impl->getValType<Impl::ValAtomDB>(Impl::PAR_atomdb);
@@ -258,6 +258,80 @@ double NC::sin_mpi8pi8(double x)
               )))))));
 }
 
+namespace NCrystal {
+  namespace {
+    //Block size for batch exp evaluations. Inputs are copied to a local buffer
+    //block by block, allowing in-place usage:
+    constexpr std::size_t exp_batch_blocksize = 256;
+
+    void exp_negarg_approx_block( const double * x, double * out, std::size_t n )
+    {
+      //Branch-free version of exp_negarg_approx, for arguments which need at
+      //most one range reduction step (x>=-25.6), with other arguments fixed up
+      //at the end. The compiler is not allowed to speculatively evaluate
+      //floating point operations in conditional branches, and would then not
+      //vectorise the loops. For that reason, all values are computed in
+      //separate passes, and the ?: operators only select between them:
+      nc_assert( n <= exp_batch_blocksize );
+      double xr[exp_batch_blocksize];
+      double y[exp_batch_blocksize];
+      for ( std::size_t i = 0; i < n; ++i ) {
+        nc_assert( x[i] <= 0.0 );
+        xr[i] = x[i] * 0.00390625;
+      }
+      for ( std::size_t i = 0; i < n; ++i )
+        xr[i] = ( x[i] < -0.1 ? xr[i] : x[i] );
+      for ( std::size_t i = 0; i < n; ++i ) {
+        const double yi = exp_smallarg_approx( xr[i] );
+        double y2 = yi;
+        y2*=y2; y2*=y2; y2*=y2; y2*=y2;
+        y2*=y2; y2*=y2; y2*=y2; y2*=y2;
+        y[i] = yi;
+        xr[i] = y2;
+      }
+      for ( std::size_t i = 0; i < n; ++i )
+        out[i] = ( x[i] < -0.1 ? xr[i] : y[i] );
+      for ( std::size_t i = 0; i < n; ++i ) {
+        if ( x[i]*0.00390625 < -0.1 )
+          out[i] = exp_negarg_approx( x[i] );
+      }
+    }
+  }
+}
+
+void NC::exp_negarg_approx( span<const double> x, span<double> out )
+{
+  nc_assert_always( x.size() == out.size() );
+  double buf[exp_batch_blocksize];
+  const std::size_t n = x.size();
+  for ( std::size_t i = 0; i < n; i += exp_batch_blocksize ) {
+    const std::size_t nblock = ncmin( exp_batch_blocksize, n - i );
+    std::copy( x.data() + i, x.data() + i + nblock, buf );
+    exp_negarg_approx_block( buf, out.data() + i, nblock );
+  }
+}
+
+void NC::exp_approx( span<const double> x, span<double> out )
+{
+  //Same as exp_negarg_approx(-|x|), inverting results for x>0:
+  nc_assert_always( x.size() == out.size() );
+  double buf[exp_batch_blocksize];
+  double tmp[exp_batch_blocksize];
+  const std::size_t n = x.size();
+  for ( std::size_t i = 0; i < n; i += exp_batch_blocksize ) {
+    const std::size_t nblock = ncmin( exp_batch_blocksize, n - i );
+    std::copy( x.data() + i, x.data() + i + nblock, buf );
+    for ( std::size_t j = 0; j < nblock; ++j )
+      tmp[j] = -std::fabs( buf[j] );
+    double * o = out.data() + i;
+    exp_negarg_approx_block( tmp, o, nblock );
+    for ( std::size_t j = 0; j < nblock; ++j )
+      tmp[j] = 1.0 / o[j];
+    for ( std::size_t j = 0; j < nblock; ++j )
+      o[j] = ( buf[j] > 0.0 ? tmp[j] : o[j] );
+  }
+}
+
 double NC::estimateDerivative(const Fct1D* f, double x, double h, unsigned order)
 {
   nc_assert(f);
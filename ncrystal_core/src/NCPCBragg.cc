@@ -129,17 +129,27 @@ NCrystal::PCBragg::PCBragg(const Info*ci)
     NCRYSTAL_THROW(MissingInfo,"Passed Info object lacks Structure information.");
   std::vector<std::pair<double, double> > data;
   data.reserve(ci->nHKL());
-  HKLList::const_iterator it = ci->hklBegin();
-  HKLList::const_iterator itE = ci->hklEnd();
-  for (;it!=itE;++it) {
-    double f = it->fsquared * it->multiplicity;
+  auto addPlane = [&data](double dspacing, double fsquared, unsigned multiplicity)
+  {
+    double f = fsquared * multiplicity;
     if (f<0)
       NCRYSTAL_THROW(CalcError,"Inconsistent data implies negative |F|^2*multiplicity.");
-    if (data.empty()||data.back().first!=it->dspacing) {
-      data.emplace_back(it->dspacing,f);
+    if (data.empty()||data.back().first!=dspacing) {
+      data.emplace_back(dspacing,f);
     } else {
       data.back().second += f;
     }
+  };
+  if (ci->hasHKLArrays()) {
+    //Avoid triggering expansion of normals in HKLInfo objects:
+    const HKLArrays& arr = ci->hklArrays();
+    for (std::size_t i = 0; i < arr.size(); ++i)
+      addPlane(arr.dspacing[i],arr.fsquared[i],arr.multiplicity[i]);
+  } else {
+    HKLList::const_iterator it = ci->hklBegin();
+    HKLList::const_iterator itE = ci->hklEnd();
+    for (;it!=itE;++it)
+      addPlane(it->dspacing,it->fsquared,it->multiplicity);
   }
   init(ci->getStructureInfo(),data);
 }
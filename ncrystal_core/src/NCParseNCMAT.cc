@@ -52,7 +52,16 @@ namespace NCrystal {
   private:
 
     typedef VectS Parts;
+    //Zero-copy views of the parts of a line (i.e. without creating
+    //std::string objects):
+    struct PartView {
+      const char * begin;
+      const char * end;
+      char front() const { return *begin; }
+    };
+    typedef std::vector<PartView> PartViews;
     void parseFile( TextInputStream& );
+    void parseLine( const std::string&, PartViews&, unsigned linenumber ) const;
     void parseLine( const std::string&, Parts&, unsigned linenumber ) const;
     void validateElementName(const std::string& s, unsigned lineno) const;
     double str2dbl_withfractions(const std::string&) const;
@@ -69,6 +78,12 @@ namespace NCrystal {
     void handleSectionData_ATOMDB(const Parts&,unsigned);
     void handleSectionData_CUSTOM(const Parts&,unsigned);
 
+    //Parse numbers into active vector field in @DYNINFO section (shared
+    //between handleSectionData_DYNINFO and the fast path in parseFile which
+    //is used for continuation lines of long vectors):
+    void appendDynInfoVectorEntries( VectD& target, const PartView* it, const PartView* itE,
+                                     unsigned first_entry_idx, unsigned lineno );
+
     //Collected data:
     NCMATData m_data;
 
@@ -201,14 +216,16 @@ void NC::NCMATParser::parseFile( TextInputStream& input )
   unsigned lineno(1);
   Parts parts;
   parts.reserve(16);
+  PartViews partviews;
+  partviews.reserve(16);
 
   bool sawAnySection = false;
   while ( input.getLine(line) ) {
 
-    parseLine(line,parts,++lineno);
+    parseLine(line,partviews,++lineno);
 
     if (m_data.version==1 && contains(line,'#')) {
-      if (sawAnySection||(!parts.empty()&&parts.at(0)[0]=='@')||line.at(0)!='#')
+      if (sawAnySection||(!partviews.empty()&&partviews.front().front()=='@')||line.at(0)!='#')
         NCRYSTAL_THROW2(BadInput,m_data.sourceFullDescr<<" has comments in a place which "
                         "is not allowed in the NCMAT v1 format"" (must only appear "
                         "before the first data section and with the # marker at the"
@@ -216,9 +233,26 @@ void NC::NCMATParser::parseFile( TextInputStream& input )
     }
 
     //ignore lines which are empty or only whitespace and comments:
-    if (parts.empty())
+    if (partviews.empty())
       continue;
 
+    //Fast path for lines continuing a long list of numbers in a @DYNINFO
+    //section (e.g. sab or vdos_density), avoiding the creation of
+    //intermediate std::string objects:
+    if ( m_dyninfo_active_vector_field && itSection->second == &NCMATParser::handleSectionData_DYNINFO ) {
+      const char c0 = partviews.front().front();
+      if ( c0 != '@' && !( c0 >= 'a' && c0 <= 'z' ) ) {
+        appendDynInfoVectorEntries( *m_dyninfo_active_vector_field, &partviews.front(),
+                                    &partviews.front() + partviews.size(), 0, lineno );
+        continue;
+      }
+    }
+
+    //Generic path:
+    parts.clear();
+    for ( auto& pv : partviews )
+      parts.emplace_back( pv.begin, pv.end - pv.begin );
+
     if (parts.at(0)[0]=='@') {
       //New section marker! First check that the syntax of this line is valid:
       sawAnySection = true;
@@ -303,6 +337,18 @@ void NC::NCMATParser::parseFile( TextInputStream& input )
 void NC::NCMATParser::parseLine( const std::string& line,
                                  Parts& parts,
                                  unsigned lineno ) const
+{
+  PartViews pvs;
+  parseLine(line,pvs,lineno);
+  parts.clear();
+  parts.reserve(pvs.size());
+  for ( auto& pv : pvs )
+    parts.emplace_back( pv.begin, pv.end - pv.begin );
+}
+
+void NC::NCMATParser::parseLine( const std::string& line,
+                                 PartViews& parts,
+                                 unsigned lineno ) const
 {
   //Ignore trailing comments and split line on all whitespace to return the
   //actual parts in a vector. This function is a bit like
@@ -342,7 +388,7 @@ void NC::NCMATParser::parseLine( const std::string& line,
       //A whitespace character (we don't support silly stuff like vertical tabs,
       //and we kind of only grudgingly and silent accept tabs as well)
       if (partbegin) {
-        parts.emplace_back(partbegin,c-partbegin);
+        parts.push_back({partbegin,c});
         partbegin=0;
       }
       continue;
@@ -398,7 +444,7 @@ void NC::NCMATParser::parseLine( const std::string& line,
   }
   if (partbegin) {
     //still need to add last part
-    parts.emplace_back(partbegin,c-partbegin);
+    parts.push_back({partbegin,c});
     partbegin=0;
   }
 
@@ -683,41 +729,55 @@ void NC::NCMATParser::handleSectionData_DYNINFO(const Parts& parts, unsigned lin
     parse_target = m_dyninfo_active_vector_field;
 
   nc_assert_always( parse_target && itParseToVect != itParseToVectE );
-  std::size_t idx = (itParseToVect-parts.begin());
-  std::string tmp_strcache0, tmp_strcache1;
-  for (; itParseToVect!=itParseToVectE; ++itParseToVect,++idx) {
+  PartViews pvs;
+  pvs.reserve( itParseToVectE - itParseToVect );
+  for ( ; itParseToVect != itParseToVectE; ++itParseToVect )
+    pvs.push_back( { itParseToVect->c_str(), itParseToVect->c_str() + itParseToVect->size() } );
+  appendDynInfoVectorEntries( *parse_target, &pvs.front(), &pvs.front() + pvs.size(),
+                              static_cast<unsigned>( parts.size() - pvs.size() ), lineno );
+}
+
+void NC::NCMATParser::appendDynInfoVectorEntries( VectD& target, const PartView* it, const PartView* itE,
+                                                  unsigned first_entry_idx, unsigned lineno )
+{
+  const std::string& e1 = m_data.sourceFullDescr;
+  nc_assert_always( it && itE > it );
+  target.reserve( target.size() + ( itE - it ) );
+  const PartView* itBegin = it;
+  for (; it!=itE; ++it) {
     double val;
-    const std::string * srcnumstr = &(*itParseToVect);
-    const std::string * srcrepeatstr = 0;
+    const char * numEnd = it->end;
+    const char * repeatBegin = nullptr;
     //First check for compact notation of repeated entries:
-    auto idx_repeat_marker = srcnumstr->find('r');
-    if (idx_repeat_marker != std::string::npos) {
-      tmp_strcache0.assign(*srcnumstr,0,idx_repeat_marker);
-      tmp_strcache1.assign(*srcnumstr,idx_repeat_marker+1,srcnumstr->size()-(idx_repeat_marker+1));
-      srcnumstr = &tmp_strcache0;
-      srcrepeatstr = &tmp_strcache1;
+    for ( const char * c = it->begin; c != it->end; ++c ) {
+      if ( *c == 'r' ) {
+        numEnd = c;
+        repeatBegin = c + 1;
+        break;
+      }
     }
+    const unsigned entry_idx = first_entry_idx + 1 + static_cast<unsigned>( it - itBegin );
 
     unsigned repeat_count = 1;
     try {
-      if (srcrepeatstr) {
-        int irc = str2int(*srcrepeatstr);
+      if (repeatBegin) {
+        int irc = str2int(std::string(repeatBegin,it->end-repeatBegin));
         if (irc<2)
           NCRYSTAL_THROW2(BadInput,"repeated entry count parameter must be >= 2");
         repeat_count = irc;
       }
-      val = str2dbl(*srcnumstr);
+      if ( !safe_str2dbl( it->begin, numEnd, val ) )
+        NCRYSTAL_THROW2(BadInput,"Invalid number in string is not a double: \""<<std::string(it->begin,numEnd-it->begin)<<"\"");
     } catch (Error::BadInput&e) {
-      NCRYSTAL_THROW2(BadInput,e1<<" problem while decoding vector entry #"<<1+(itParseToVect-parts.begin())<<" in line "<<lineno<<" : "<<e.what());
+      NCRYSTAL_THROW2(BadInput,e1<<" problem while decoding vector entry #"<<entry_idx<<" in line "<<lineno<<" : "<<e.what());
     }
     if (ncisnan(val)||ncisinf(val))
-      NCRYSTAL_THROW2(BadInput,e1<<" problem while decoding vector entry #"<<1+(itParseToVect-parts.begin())<<" in line "<<lineno<<" : NaN or infinite number");
+      NCRYSTAL_THROW2(BadInput,e1<<" problem while decoding vector entry #"<<entry_idx<<" in line "<<lineno<<" : NaN or infinite number");
     if ( !m_dyninfo_active_vector_field_allownegative && val<0.0 )
-      NCRYSTAL_THROW2(BadInput,e1<<" problem while decoding vector entry #"<<1+(itParseToVect-parts.begin())<<" in line "<<lineno<<" : Negative number");
+      NCRYSTAL_THROW2(BadInput,e1<<" problem while decoding vector entry #"<<entry_idx<<" in line "<<lineno<<" : Negative number");
     while (repeat_count--)
-      parse_target->push_back(val);
+      target.push_back(val);
   }
-
 }
 
 void NC::NCMATParser::handleSectionData_DENSITY(const Parts& parts, unsigned lineno)
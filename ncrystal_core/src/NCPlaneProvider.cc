@@ -41,17 +41,22 @@ namespace NCrystal {
 
   private:
     RCHolder<const Info> m_info;
-    enum{ STRAT_MISSING, STRAT_DEMINORMAL, STRAT_EXPHKL, STRAT_SPACEGROUP } m_strategy;
+    enum{ STRAT_MISSING, STRAT_DEMINORMAL, STRAT_DEMINORMAL_ARRAYS, STRAT_EXPHKL, STRAT_SPACEGROUP } m_strategy;
     //outer loop:
     HKLList::const_iterator m_it_hklE;
     HKLList::const_iterator m_it_hkl;
     //inner loop counter (common for STRAT_DEMINORMAL + STRAT_EXPHKL)
     size_t m_ii;
+    //needed just for STRAT_DEMINORMAL_ARRAYS (m_ii is then the index of the
+    //normal in the flat arrays):
+    const HKLArrays * m_arrays;
+    size_t m_iplane;
     RotMatrix m_reci_lattice;
     //needed just for STRAT_SPACEGROUP:
     struct StrSG;
     StrSG * m_sg;
     bool gnp_de(double& dspacing, double& fsq, Vector& normal);
+    bool gnp_da(double& dspacing, double& fsq, Vector& normal);
     bool gnp_eh(double& dspacing, double& fsq, Vector& normal);
     bool gnp_sg(double& dspacing, double& fsq, Vector& normal);
   };
@@ -59,7 +64,7 @@ namespace NCrystal {
   struct PlaneProviderStd::StrSG {
     StrSG(int spacegroup) : m_eqreflcalc(spacegroup) {}
     void prepareLoop(int h, int k, int l, unsigned expected_multiplicity ) {
-      const std::set<EqRefl::HKL>& el = m_eqreflcalc.getEquivalentReflections(h,k,l);
+      const EqRefl::HKLSet& el = m_eqreflcalc.getEquivalentReflections(h,k,l);
       if ( el.size() * 2 != expected_multiplicity ) {
         NCRYSTAL_THROW2(MissingInfo,"Incomplete information for selected modeling: Neither"
                         " HKL normals nor expanded HKL info available, and the HKL grouping in the"
@@ -71,7 +76,8 @@ namespace NCrystal {
       it = el.begin();
       itE = el.end();
     }
-    std::set<EqRefl::HKL>::const_iterator it,itE;
+    const EqRefl::HKL * it;
+    const EqRefl::HKL * itE;
   private:
     EqRefl m_eqreflcalc;
   };
@@ -81,10 +87,16 @@ namespace NCrystal {
       m_info(cinfo),
       m_strategy(STRAT_MISSING),
       m_ii(0),
+      m_arrays(nullptr),
+      m_iplane(0),
       m_sg(0)
   {
     nc_assert(cinfo);
-    if (cinfo->hasHKLInfo()) {
+    if (cinfo->hasHKLInfo() && cinfo->hasHKLArrays() && cinfo->hasHKLDemiNormals() ) {
+      //Use flat arrays directly (avoiding expansion of the HKLInfo objects):
+      m_strategy = STRAT_DEMINORMAL_ARRAYS;
+      m_arrays = &cinfo->hklArrays();
+    } else if (cinfo->hasHKLInfo()) {
       m_it_hkl  = cinfo->hklBegin();
       m_it_hklE = cinfo->hklEnd();
       if ( cinfo->hasHKLDemiNormals() ) {
@@ -119,7 +131,10 @@ namespace NCrystal {
       NCRYSTAL_THROW(MissingInfo,"Insufficient information for plane normals: Neither"
                      " HKL normals, expanded HKL info, or spacegroup number is available.");
     m_ii = 0;
+    m_iplane = 0;
     nc_assert(m_info.obj());
+    if ( m_strategy == STRAT_DEMINORMAL_ARRAYS )
+      return;
     m_it_hkl  = m_info->hklBegin();
     m_it_hklE = m_info->hklEnd();
     if ( m_sg ) {
@@ -133,6 +148,7 @@ namespace NCrystal {
   {
     switch(m_strategy) {
     case STRAT_DEMINORMAL: return gnp_de(dspacing,fsq,demi_normal);
+    case STRAT_DEMINORMAL_ARRAYS: return gnp_da(dspacing,fsq,demi_normal);
     case STRAT_EXPHKL: return gnp_eh(dspacing,fsq,demi_normal);
     case STRAT_SPACEGROUP: return gnp_sg(dspacing,fsq,demi_normal);
     case STRAT_MISSING:
@@ -158,6 +174,22 @@ namespace NCrystal {
     return true;
   }
 
+  bool PlaneProviderStd::gnp_da(double& dspacing, double& fsq, Vector& demi_normal)
+  {
+    nc_assert(m_arrays);
+    const HKLArrays& arr = *m_arrays;
+    if (m_ii == arr.normal_x.size())
+      return false;
+    while ( m_ii == arr.normals_offset[m_iplane+1] )
+      ++m_iplane;
+    nc_assert( m_iplane < arr.size() );
+    dspacing = arr.dspacing[m_iplane];
+    fsq = arr.fsquared[m_iplane];
+    demi_normal.set(arr.normal_x[m_ii], arr.normal_y[m_ii], arr.normal_z[m_ii]);
+    ++m_ii;
+    return true;
+  }
+
   bool PlaneProviderStd::gnp_eh(double& dspacing, double& fsq, Vector& demi_normal)
   {
     if (m_it_hkl == m_it_hklE)
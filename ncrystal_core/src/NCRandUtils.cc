@@ -99,88 +99,158 @@ void NC::randPointOnUnitCircle( NC::RandomBase * rand,  double & x, double& y )
 }
 
 
-double NC::randNorm( NC::RandomBase * rand )
-{
-  //sample a single value from a unit normal distribution via the ratio method.
-  //
-  //This method is ~30% faster than the randNorm(g1,g2) (using a decent Mersenne
-  //Twister RNG), but only provides a single number. TODO: re-benchmark using our new rng.
-  //
-  //The loop runs on average ~1.37 times, and log(..) is invoked on average
-  //0.167 times per call (hence the speedup).
+namespace NCrystal {
+  namespace {
+
+    //Tables for ziggurat sampling (Marsaglia and Tsang, J. Stat. Softw. 5 (2000)
+    //doi:10.18637/jss.v005.i08), in the formulation of Doornik (2005) where
+    //strip i spans [0,x[i]] and the base strip (i=0) has pseudo-width
+    //x[0]=v/f(r) such that it has the same area, v, as the other strips. The
+    //tables are built once, upon first usage:
+    template<unsigned N>
+    struct ZigguratTables {
+      double x[N+1];//strip edges, x[0]=v/f(r), x[1]=r, ..., x[N]=0
+      double ratio[N];//x[i+1]/x[i]
+      double fx[N+1];//f(x[i])
+      template<class TFct, class TInvFct>
+      ZigguratTables( double r, double v, TFct f, TInvFct finv )
+      {
+        x[0] = v / f(r);
+        x[1] = r;
+        for ( unsigned i = 2; i < N; ++i ) {
+          const double y = v / x[i-1] + f(x[i-1]);
+          x[i] = ( y < 1.0 ? finv(y) : 0.0 );
+        }
+        x[N] = 0.0;
+        for ( unsigned i = 0; i < N; ++i )
+          ratio[i] = x[i+1] / x[i];
+        for ( unsigned i = 0; i <= N; ++i )
+          fx[i] = f(x[i]);
+      }
+    };
+
+    //Unit Gaussian (unnormalised f(x)=exp(-x^2/2)), 128 strips:
+    constexpr double zig_norm_r = 3.442619855899;
+    const ZigguratTables<128>& zigTablesNorm()
+    {
+      static const ZigguratTables<128> s_tables( zig_norm_r, 9.91256303526217e-3,
+                                                 [](double x) { return std::exp(-0.5*x*x); },
+                                                 [](double y) { return std::sqrt(-2.0*std::log(y)); } );
+      return s_tables;
+    }
 
-  double g, g2(0),u,v,invu;
-  do {
-    u = rand->generate();
-    nc_assert(u);
-    invu = 1.0/u;
-    v = rand->generate();
-    g = 1.71552776992141354 * (v-0.5)*invu;
-    g2 = g*g;
-    if ( g2 <= 5.0 - 5.13610166675096558 * u )
-      break;
-    if ( g2 >= 1.03696104258356603 * invu )
+    //Exponential (f(x)=exp(-x)), 256 strips:
+    constexpr double zig_exp_r = 7.69711747013104972;
+    const ZigguratTables<256>& zigTablesExp()
+    {
+      static const ZigguratTables<256> s_tables( zig_exp_r, 3.949659822581572e-3,
+                                                 [](double x) { return std::exp(-x); },
+                                                 [](double y) { return -std::log(y); } );
+      return s_tables;
+    }
+
+    //Sample exp(-x^2/2) for x>r (Marsaglia), using ziggurat exponentials:
+    double randNormTailMarsaglia( double r, NC::RandomBase& rng )
+    {
+      nc_assert(r>0.0);
+      const double invr = 1.0/r;
+      while (true) {
+        const double x = invr * NC::randExp(rng);
+        const double y = NC::randExp(rng);
+        if (2*y > x*x)
+          return x + r;
+      }
+    }
+  }
+}
+
+double NC::randExp( NC::RandomBase& rng )
+{
+  //Ziggurat sampling of exp(-x). The strip index and the position within the
+  //strip are both taken from a single uniform number (strip from the top 8
+  //bits). In ~99% of calls the sampled point is inside the rectangular part
+  //of a strip, and the result is returned after a single call to the RNG and
+  //no transcendental functions:
+  static const ZigguratTables<256>& zt = zigTablesExp();
+  double offset = 0.0;
+  while (true) {
+    const double t = rng.generate() * 256.0;
+    const unsigned i = static_cast<unsigned>(t);
+    nc_assert(i<256);
+    const double u = t - i;
+    const double x = u * zt.x[i];
+    if ( u < zt.ratio[i] )
+      return offset + x;
+    if ( i == 0 ) {
+      //Tail beyond r. By the memorylessness of the exponential distribution,
+      //this is just the distribution itself shifted by r:
+      offset += zig_exp_r;
       continue;
-  } while ( g2 >= - 4.0 * std::log(u) );
-  return g;
+    }
+    //Wedge:
+    if ( zt.fx[i+1] + rng.generate() * ( zt.fx[i] - zt.fx[i+1] ) < std::exp(-x) )
+      return offset + x;
+  }
 }
 
-void NC::randNorm( NC::RandomBase * rand, double&g1, double&g2)
+double NC::randNorm( NC::RandomBase * rand )
 {
-  //sample two independent values from a unit normal distribution via the polar method.
-  //
-  //The loop runs on average 4/pi ~= 1.27 times.
+  //Ziggurat sampling of a single value from a unit normal distribution. The
+  //strip index (7 bits), the sign (1 bit) and the position within the strip
+  //are all taken from a single uniform number. In ~99% of calls the sampled
+  //point is inside the rectangular part of a strip, and the result is returned
+  //after a single call to the RNG and no transcendental functions:
+  static const ZigguratTables<128>& zt = zigTablesNorm();
+  while (true) {
+    const double t = rand->generate() * 256.0;
+    const unsigned j = static_cast<unsigned>(t);
+    nc_assert(j<256);
+    const double u = t - j;
+    const unsigned i = j & 0x7F;
+    const bool negative = j & 0x80;
+    const double x = u * zt.x[i];
+    if ( u < zt.ratio[i] )
+      return negative ? -x : x;
+    if ( i == 0 ) {
+      const double xtail = randNormTailMarsaglia( zig_norm_r, *rand );
+      return negative ? -xtail : xtail;
+    }
+    //Wedge:
+    if ( zt.fx[i+1] + rand->generate() * ( zt.fx[i] - zt.fx[i+1] ) < std::exp(-0.5*x*x) )
+      return negative ? -x : x;
+  }
+}
 
-  double t;
-  do {
-    g1 = 2.0 * rand->generate() - 1.0;
-    g2 = 2.0 * rand->generate() - 1.0;
-    t = g1 * g1 + g2 * g2;
-  } while ( t >= 1.0 || !t );
-  t = std::sqrt( (-2.0 * std::log( t ) ) / t );
-  g1 *= t;
-  g2 *= t;
+void NC::randNorm( NC::RandomBase * rand, double&g1, double&g2)
+{
+  //sample two independent values from a unit normal distribution (with the
+  //ziggurat method, there is no longer any gain in generating them together).
+  g1 = randNorm( rand );
+  g2 = randNorm( rand );
 }
 
 double NC::randNormTail(double tail, NC::RandomBase& rng)
 {
   nc_assert(tail>=0.0);
-  if (tail > 0.8) {
+  if (tail > 1.0) {
     //"far" out on the tail, it would be inefficient to just generate normally
     //distributed numbers until one would fall above tail. Instead use
-    //Marsaglias tail for normal distribution (used when implementing the
-    //exponential distribution with ziggurat sampling,
-    //cf. https://en.wikipedia.org/wiki/Ziggurat_algorithm):
+    //Marsaglias tail for normal distribution (also used for the base strip of
+    //the ziggurat sampling in randNorm).
     //
-    //NB: The threshold value 0.8 came out of benchmarks. If e.g. -log(R)
-    //would be replaced by something faster, this should be retuned.
-    double minvtail = -1.0/tail;
-    while (true) {
-      //NB: If we ever implement a faster alternative to -log(R) exponential
-      //sampling, we can use it here instead!
-      double x = minvtail * std::log(rng.generate());
-      double y = - std::log(rng.generate());
-      if (2*y > x*x)
-        return x + tail;
-    }
+    //NB: The threshold value 1.0 is where the acceptance rate of Marsaglias
+    //method (which needs two exponential numbers per attempt) becomes better
+    //than twice that of rejecting central values from randNorm (which needs
+    //one normal number per attempt), given that randExp and randNorm now have
+    //nearly identical costs.
+    return randNormTailMarsaglia( tail, rng );
   }
   //not far out on the tail, most efficient is to just use normal alg and
   //reject central values.
   while (true) {
-#if 1
-    double g1, g2;
-    randNorm(&rng,g1,g2);//use version providing two numbers at once,
-    //i.e. optimize "worst case" performance (tail~=1)
-    //rather than "best case" performance (tail~=0).
-    if (std::abs(g1)>tail)
-      return std::abs(g1);
-    if (std::abs(g2)>tail)
-      return std::abs(g2);
-#else
-    double g1 = randNorm(&rng);
-    if (std::abs(g1)>tail)
-      return std::abs(g1);
-#endif
+    double g1 = ncabs( randNorm(&rng) );
+    if (g1>tail)
+      return g1;
   }
 }
 
@@ -251,6 +321,21 @@ double NC::randExpDivSqrt( RandomBase& rng, double c, double a, double b )
 
     const double U = c*(b-a);
     const double invA = 1.0/A;
+
+    if ( U > 3.0 ) {
+      //Since exp(-3)<5%, it is cheaper to sample exp(-u) on [0,inf] with the
+      //ziggurat method (no transcendental functions in most cases) and reject
+      //values above U, than to use the std::log based interval sampler:
+      while (true) {
+        double ugen = randExp(rng);
+        if ( ugen > U )
+          continue;
+        double R = rng.generate();//cost 1 RNG
+        if ( (1.0+ugen*invA)*R*R<1.0 )
+          return ncclamp( (ugen+A)/c, a, b );//accepted, return corresponding x.
+      }
+    }
+
     RandExpIntervalSampler expsampler(0,U,1.0);//cost 1 std::expm1
 
     while (true) {
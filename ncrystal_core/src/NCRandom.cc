@@ -23,24 +23,92 @@
 #include "NCrystal/internal/NCMath.hh"
 #include <cstdio>
 #include <algorithm>
+#include <mutex>
+#include <atomic>
 
 namespace NCrystal {
-  static RCHolder<RandomBase> s_default_randgen;
+  namespace {
+    //Reference counts of RCBase objects are not atomic, so all references to
+    //default generators below are acquired and released with this mutex held:
+    std::mutex s_randgen_mutex;
+    RCHolder<RandomBase> s_default_randgen;
+    //Incremented whenever s_default_randgen changes, allowing threads to
+    //detect that their cached reference to the global default is outdated:
+    std::atomic<uint64_t> s_default_randgen_version(1);
+
+    //References held by each thread, to the generator bound to it with
+    //setThreadDefaultRandomGenerator and to the global default last used by
+    //it. The latter ensures that replacing the global default will not delete
+    //a generator while another thread is still using it:
+    struct ThreadRandGens {
+      RCHolder<RandomBase> bound;
+      RCHolder<RandomBase> global;
+      ~ThreadRandGens()
+      {
+        std::lock_guard<std::mutex> guard(s_randgen_mutex);
+        bound.clear();
+        global.clear();
+      }
+    };
+    thread_local ThreadRandGens s_thread_randgens;
+    //Plain copies of the pointers for the fast path, since access to trivial
+    //thread_local variables avoids the overhead of dynamic initialisation checks:
+    thread_local RandomBase * s_thread_bound_ptr = nullptr;
+    thread_local RandomBase * s_thread_global_ptr = nullptr;
+    thread_local uint64_t s_thread_global_version = 0;
+
+    RandomBase * lockedDefaultRandomGenerator(bool trigger_default)
+    {
+      //NB: s_randgen_mutex must be held by calling code.
+      if ( !s_default_randgen.obj() && trigger_default ) {
+        s_default_randgen = new RandXRSR;
+        ++s_default_randgen_version;
+      }
+      return s_default_randgen.obj();
+    }
+
+    RandomBase * updateThreadGlobalRandomGenerator(bool trigger_default)
+    {
+      std::lock_guard<std::mutex> guard(s_randgen_mutex);
+      RandomBase * rg = lockedDefaultRandomGenerator(trigger_default);
+      s_thread_randgens.global = rg;
+      s_thread_global_ptr = rg;
+      s_thread_global_version = s_default_randgen_version.load();
+      return rg;
+    }
+  }
 }
 
 void NCrystal::setDefaultRandomGenerator(RandomBase* rg)
 {
+  std::lock_guard<std::mutex> guard(s_randgen_mutex);
+  if ( rg == s_default_randgen.obj() )
+    return;
   s_default_randgen = rg;
+  ++s_default_randgen_version;
 }
 
 NCrystal::RandomBase * NCrystal::defaultRandomGenerator(bool trigger_default)
 {
-  if (!s_default_randgen.obj()) {
-    if (!trigger_default)
-      return 0;
-    s_default_randgen = new RandXRSR;
-  }
-  return s_default_randgen.obj();
+  std::lock_guard<std::mutex> guard(s_randgen_mutex);
+  return lockedDefaultRandomGenerator(trigger_default);
+}
+
+void NCrystal::setThreadDefaultRandomGenerator(RandomBase* rg)
+{
+  std::lock_guard<std::mutex> guard(s_randgen_mutex);
+  s_thread_randgens.bound = rg;
+  s_thread_bound_ptr = rg;
+}
+
+NCrystal::RandomBase * NCrystal::threadDefaultRandomGenerator(bool trigger_default)
+{
+  if ( s_thread_bound_ptr )
+    return s_thread_bound_ptr;
+  if ( s_thread_global_version == s_default_randgen_version.load(std::memory_order_acquire)
+       && ( s_thread_global_ptr || !trigger_default ) )
+    return s_thread_global_ptr;
+  return updateThreadGlobalRandomGenerator(trigger_default);
 }
 
 //For reference we include here the code with comments which was found on
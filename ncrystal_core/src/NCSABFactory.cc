@@ -22,14 +22,15 @@
 #include "NCrystal/internal/NCSABIntegrator.hh"
 #include "NCrystal/internal/NCMath.hh"
 #include "NCrystal/internal/NCFactoryUtils.hh"
+#include <algorithm>
 
 namespace NC = NCrystal;
 
 namespace NCrystal {
   namespace SAB {
 
-    //Cache key is (sabdata uid, egrid uid, sabdata ptr):
-    typedef std::tuple<UniqueIDValue,UniqueIDValue,std::shared_ptr<const NC::SABData>*> ScatHelperCacheKey;
+    //Cache key is (sabdata uid, egrid uid, sabdata ptr, sabfloat, egridtol, nalphatab):
+    typedef std::tuple<UniqueIDValue,UniqueIDValue,std::shared_ptr<const NC::SABData>*,unsigned,double,unsigned> ScatHelperCacheKey;
 
     class ScatterHelperFactory : public NC::CachedFactoryBase<ScatHelperCacheKey,SABScatterHelper> {
     public:
@@ -37,7 +38,7 @@ namespace NCrystal {
       std::string keyToString( const ScatHelperCacheKey& key ) const final
       {
         std::ostringstream ss;
-        ss<<"(SABData id="<<std::get<0>(key).value<<";egrid id="<<std::get<1>(key).value<<")";
+        ss<<"(SABData id="<<std::get<0>(key).value<<";egrid id="<<std::get<1>(key).value<<";sabfloat="<<std::get<3>(key)<<";egridtol="<<std::get<4>(key)<<";nalphatab="<<std::get<5>(key)<<")";
         return ss.str();
       }
     protected:
@@ -46,7 +47,7 @@ namespace NCrystal {
         auto sabdata_shptr = *std::get<2>(key);
         nc_assert( sabdata_shptr->getUniqueID() == std::get<0>(key) );
         auto egrid_shptr = egridFromUniqueID(std::get<1>(key));
-        return createScatterHelper(std::move(sabdata_shptr),std::move(egrid_shptr));
+        return createScatterHelper(std::move(sabdata_shptr),std::move(egrid_shptr),std::get<3>(key),std::get<4>(key),std::get<5>(key));
       }
     };
 
@@ -55,10 +56,13 @@ namespace NCrystal {
 }
 
 std::unique_ptr<const NC::SAB::SABScatterHelper> NC::SAB::createScatterHelper( std::shared_ptr<const NC::SABData> data,
-                                                                               std::shared_ptr<const VectD> energyGrid )
+                                                                               std::shared_ptr<const VectD> energyGrid,
+                                                                               unsigned sabfloat,
+                                                                               double egridtol,
+                                                                               unsigned nalphatab )
 {
   nc_assert(!!data);
-  SABIntegrator si(data,energyGrid.get());
+  SABIntegrator si(data,energyGrid.get(),nullptr,sabfloat,egridtol,nalphatab);
   auto sh = si.createScatterHelper();
   return std::make_unique<SABScatterHelper>(std::move(sh));
 }
@@ -68,13 +72,20 @@ void NC::SAB::clearScatterHelperCache() {
 }
 
 std::shared_ptr<const NC::SAB::SABScatterHelper> NC::SAB::createScatterHelperWithCache( std::shared_ptr<const NC::SABData> dataptr,
-                                                                                        std::shared_ptr<const VectD> egrid )
+                                                                                        std::shared_ptr<const VectD> egrid,
+                                                                                        unsigned sabfloat,
+                                                                                        double egridtol,
+                                                                                        unsigned nalphatab )
 {
   nc_assert_always(!!dataptr);
+  dataptr = internSABData( std::move(dataptr) );
 
   ScatHelperCacheKey key( dataptr->getUniqueID(),
                           egridToUniqueID( egrid ),
-                          &dataptr );
+                          &dataptr,
+                          sabfloat,
+                          egridtol,
+                          nalphatab );
 
   return s_scathelperfact.create(key);
 }
@@ -128,6 +139,85 @@ NC::UniqueIDValue NC::SAB::egridToUniqueID(const std::shared_ptr<const NC::VectD
 }
 
 
+namespace NCrystal {
+  namespace {
+    static std::map< HashValue, std::vector<std::weak_ptr<const SABData>>> s_sabInternTable;
+    static std::mutex s_sabInternTable_mutex;
+
+    void pruneSABInternTable()
+    {
+      //Remove all expired entries (and thus empty buckets), so the table does
+      //not grow without bounds in long running processes. Must be called with
+      //the mutex locked:
+      for ( auto it = s_sabInternTable.begin(); it != s_sabInternTable.end(); ) {
+        auto& v = it->second;
+        v.erase(std::remove_if(v.begin(),v.end(),[](const std::weak_ptr<const SABData>& e) { return e.expired(); }),v.end());
+        if ( v.empty() )
+          it = s_sabInternTable.erase(it);
+        else
+          ++it;
+      }
+    }
+
+    void clearSABInternTable()
+    {
+      std::lock_guard<std::mutex> guard(s_sabInternTable_mutex);
+      s_sabInternTable.clear();
+    }
+
+    HashValue hashSABDataContent( const SABData& d )
+    {
+      HashValue h = hashContainer(d.alphaGrid());
+      hash_combine(h,hashContainer(d.betaGrid()));
+      hash_combine(h,hashContainer(d.sab()));
+      hash_combine(h,d.temperature());
+      hash_combine(h,d.boundXS().val);
+      hash_combine(h,d.elementMassAMU());
+      hash_combine(h,d.suggestedEmax());
+      return h;
+    }
+
+    bool sabDataContentEqual( const SABData& a, const SABData& b )
+    {
+      return ( a.temperature() == b.temperature()
+               && a.boundXS().val == b.boundXS().val
+               && a.elementMassAMU() == b.elementMassAMU()
+               && a.suggestedEmax() == b.suggestedEmax()
+               && a.alphaGrid() == b.alphaGrid()
+               && a.betaGrid() == b.betaGrid()
+               && a.sab() == b.sab() );
+    }
+  }
+}
+
+std::shared_ptr<const NC::SABData> NC::SAB::internSABData( std::shared_ptr<const NC::SABData> data )
+{
+  nc_assert_always(!!data);
+  //Register with clearCaches() (not while holding our own mutex, since
+  //clearCaches() invokes the cleanup functions with its own mutex locked):
+  static bool s_cleanupRegistered = [](){ registerCacheCleanupFunction( clearSABInternTable ); return true; }();
+  (void)s_cleanupRegistered;
+  //Hash outside the lock, since it involves all the S values:
+  auto hash = hashSABDataContent( *data );
+  std::lock_guard<std::mutex> guard(s_sabInternTable_mutex);
+  auto itbucket = s_sabInternTable.find(hash);
+  if ( itbucket != s_sabInternTable.end() ) {
+    //In absence of hash collisions, the bucket will usually have length 1:
+    for (auto& e : itbucket->second) {
+      auto existing = e.lock();
+      if ( existing == data )
+        return data;
+      if ( existing && sabDataContentEqual( *existing, *data ) )
+        return existing;
+    }
+  }
+  //New entry. Insertions are rare (each one follows an expensive kernel
+  //creation), so we can afford to prune the entire table here:
+  pruneSABInternTable();
+  s_sabInternTable[hash].emplace_back(data);
+  return data;
+}
+
 std::shared_ptr<const NC::VectD> NC::SAB::egridFromUniqueID( NC::UniqueIDValue uidval )
 {
   std::lock_guard<std::mutex> guard(s_egrid2uid_mutex);
@@ -23,6 +23,7 @@
 #include "NCrystal/internal/NCSABUtils.hh"
 #include "NCrystal/internal/NCFactoryUtils.hh"
 #include "NCrystal/internal/NCIter.hh"
+#include "NCrystal/NCRandom.hh"
 #include <algorithm>
 #include <iostream>
 
@@ -33,22 +34,43 @@ struct NC::SAB::SABIntegrator::Impl : private NoCopyMove {
 
   Impl( std::shared_ptr<const SABData>,
         const VectD* egrid,
-        std::shared_ptr<const SABExtender> );
+        std::shared_ptr<const SABExtender>,
+        unsigned sabfloat,
+        double egridtol,
+        unsigned nalphatab );
   void doit(SABXSProvider *, SABSampler*);
   double determineEMax( const double ) const;
   double determineEMin( const double ) const;
   void setupEnergyGrid();
+  typedef std::unique_ptr<SABSamplerAtE> SamplerAtE_uptr;
+  void refineEnergyGrid( bool doSampler, VectD& xsvals, std::vector<SamplerAtE_uptr>& samplers );
+  void reportFloatStorageDeviations( const VectD& xsvals );
 
   //Input data:
   std::shared_ptr<const SABData> m_data;
   VectD m_egrid;
   std::shared_ptr<const SABExtender> m_extender;
-
-  //Data derived from m_data:
-  std::shared_ptr<const SABSamplerAtE_Alg1::CommonCache> m_derivedData;
-
-  typedef std::unique_ptr<SABSamplerAtE> SamplerAtE_uptr;
-  std::pair<SamplerAtE_uptr,double> analyseEnergyPoint(double ekin, bool doSampler ) const;
+  unsigned m_sabfloat;
+  double m_egridtol;
+  unsigned m_nalphatab;
+  unsigned m_egridmaxpts = 0;//if >0, m_egrid is coarse grid to be refined
+
+  //Data derived from m_data (only one of these will usually be set, depending
+  //on m_sabfloat):
+  template<class TStorage>
+  using DerivedDataPtr = std::shared_ptr<const typename SABSamplerAtE_Alg1<TStorage>::CommonCache>;
+  DerivedDataPtr<double> m_derivedData_double;
+  DerivedDataPtr<float> m_derivedData_float;
+
+  template<class TStorage>
+  std::pair<SamplerAtE_uptr,double> analyseEnergyPointImpl( double ekin, bool doSampler,
+                                                            const DerivedDataPtr<TStorage>& ) const;
+  std::pair<SamplerAtE_uptr,double> analyseEnergyPoint(double ekin, bool doSampler ) const
+  {
+    return ( m_sabfloat
+             ? analyseEnergyPointImpl<float>( ekin, doSampler, m_derivedData_float )
+             : analyseEnergyPointImpl<double>( ekin, doSampler, m_derivedData_double ) );
+  }
 
   double analyseEnergyPointForXS(double ekin) const
   {
@@ -61,8 +83,11 @@ NS::SABIntegrator::~SABIntegrator() = default;
 
 NS::SABIntegrator::SABIntegrator( std::shared_ptr<const SABData> data,
                                   const VectD* egrid,
-                                  std::shared_ptr<const SABExtender> sabextender )
-  : m_impl(std::move(data),egrid,std::move(sabextender))
+                                  std::shared_ptr<const SABExtender> sabextender,
+                                  unsigned sabfloat,
+                                  double egridtol,
+                                  unsigned nalphatab )
+  : m_impl(std::move(data),egrid,std::move(sabextender),sabfloat,egridtol,nalphatab)
 {
 }
 
@@ -73,21 +98,36 @@ void NS::SABIntegrator::doit(SABXSProvider * out_xs, SABSampler* out_sampler)
 
 NS::SABIntegrator::Impl::Impl( std::shared_ptr<const SABData> data,
                                const VectD* egrid,
-                               std::shared_ptr<const SABExtender> sabextender )
+                               std::shared_ptr<const SABExtender> sabextender,
+                               unsigned sabfloat,
+                               double egridtol,
+                               unsigned nalphatab )
   : m_data(std::move(data)),
     m_egrid((egrid&&!egrid->empty())?*egrid:VectD()),
-    m_extender(!sabextender?std::make_unique<SABFGExtender>(m_data->temperature(),m_data->elementMassAMU(),SigmaBound{m_data->boundXS()}):std::move(sabextender))
+    m_extender(!sabextender?std::make_unique<SABFGExtender>(m_data->temperature(),m_data->elementMassAMU(),SigmaBound{m_data->boundXS()}):std::move(sabextender)),
+    m_sabfloat(sabfloat),
+    m_egridtol(egridtol),
+    m_nalphatab(nalphatab)
 {
+  if ( m_sabfloat > 2 )
+    NCRYSTAL_THROW2(BadInput,"SABIntegrator invalid sabfloat value: "<<m_sabfloat<<" (must be 0, 1 or 2)");
+  if ( !(m_egridtol>=0.0) || !(m_egridtol<=0.1) )
+    NCRYSTAL_THROW2(BadInput,"SABIntegrator invalid egridtol value: "<<m_egridtol<<" (must be 0 or in (0,0.1])");
+  if ( m_nalphatab == 1 )
+    NCRYSTAL_THROW(BadInput,"SABIntegrator invalid nalphatab value: 1 (must be 0 or at least 2)");
 }
 
 namespace NCrystal {
   namespace {
     //Derived data factory:
     typedef std::pair<UniqueIDValue, std::shared_ptr<const SABData>* > D2DDKey;
-    typedef SAB::SABSamplerAtE_Alg1::CommonCache DerivedData;
-    class SABData2DerivedDataFactory : public NC::CachedFactoryBase<D2DDKey,DerivedData> {
+    template<class TStorage>
+    class SABData2DerivedDataFactory : public NC::CachedFactoryBase<D2DDKey,typename SAB::SABSamplerAtE_Alg1<TStorage>::CommonCache> {
     public:
-      const char* factoryName() const final { return "SABData2DerivedDataFactory"; }
+      typedef typename SAB::SABSamplerAtE_Alg1<TStorage>::CommonCache DerivedData;
+      typedef std::shared_ptr<const DerivedData> ShPtr;
+      static constexpr bool isFloat = std::is_same<TStorage,float>::value;
+      const char* factoryName() const final { return isFloat ? "SABData2DerivedDataFactory<float>" : "SABData2DerivedDataFactory"; }
       std::string keyToString( const D2DDKey& key ) const final
       {
         std::ostringstream ss;
@@ -106,14 +146,16 @@ namespace NCrystal {
         const std::size_t nbeta = data->betaGrid().size();
         const std::size_t nalpham1 = nalpha-1;
 
-        //Calculate log(S) values:
+        //Calculate log(S) values (always in double precision, since they are
+        //also needed below):
         VectD logsab;
         logsab.reserve(sab.size());
         for (auto e: sab)
-          logsab.push_back( e>0.0 ? std::log(e) : -kInfinity);
+          logsab.push_back( SABUtils::logSVal(e) );
 
-        //For each beta-idx, integrate each grid cell along alpha:
-        VectD alphaintegrals_cumul;
+        //For each beta-idx, integrate each grid cell along alpha (accumulating
+        //in double precision, regardless of storage type):
+        std::vector<TStorage> alphaintegrals_cumul;
         alphaintegrals_cumul.resize(sab.size(),0.);
         std::size_t global_idx(0);
         for (std::size_t ibeta = 0; ibeta<nbeta; ++ibeta, ++global_idx) {
@@ -123,16 +165,22 @@ namespace NCrystal {
             double integ = SABUtils::integrateAlphaInterval_fast( vectAt( alphaGrid, ai ), vectAt( sab, global_idx ),
                                                                   vectAt( alphaGrid, ai+1 ), vectAt( sab,  next_idx ),
                                                                   vectAt( logsab, global_idx ), vectAt( logsab,  next_idx ) );
-            vectAt( alphaintegrals_cumul, next_idx ) = (cumul += integ);
+            vectAt( alphaintegrals_cumul, next_idx ) = static_cast<TStorage>(cumul += integ);
           }
         }
         nc_assert(global_idx==sab.size());
 
-        //Wrap up and return:
-        return std::make_shared<const DerivedData>(DerivedData{data,std::move(logsab),std::move(alphaintegrals_cumul)});
+        //Wrap up and return (the log(S) values are not kept with float storage):
+        std::vector<TStorage> logsab_stored;
+        if (!isFloat)
+          logsab_stored.assign(logsab.begin(),logsab.end());
+        logsab.clear();
+        logsab.shrink_to_fit();
+        return std::make_shared<const DerivedData>(DerivedData{data,std::move(logsab_stored),std::move(alphaintegrals_cumul)});
       }
     };
-    static SABData2DerivedDataFactory s_SABData2DerivedDataFactory;
+    static SABData2DerivedDataFactory<double> s_SABData2DerivedDataFactory;
+    static SABData2DerivedDataFactory<float> s_SABData2DerivedDataFactory_float;
 
   }
 }
@@ -258,7 +306,14 @@ void NS::SABIntegrator::Impl::setupEnergyGrid()
     nc_assert_always(emin>0.0);
     nc_assert_always(emax>emin);
     nc_assert_always(npts>=2);
-    m_egrid = NC::geomspace(emin,emax,npts);
+    if ( m_egridtol > 0.0 ) {
+      //Start from a coarse grid, to be refined in refineEnergyGrid (never
+      //exceeding npts points in total):
+      m_egridmaxpts = npts;
+      m_egrid = NC::geomspace(emin,emax,ncmin(npts,20u));
+    } else {
+      m_egrid = NC::geomspace(emin,emax,npts);
+    }
   }
 
   if ( m_egrid.size() < 10 )
@@ -272,8 +327,13 @@ void NS::SABIntegrator::Impl::setupEnergyGrid()
 void NS::SABIntegrator::Impl::doit(SABXSProvider * out_xs, SABSampler* out_sampler)
 {
   nc_assert_always( out_xs || out_sampler );
-  if ( !m_derivedData )
-    m_derivedData = s_SABData2DerivedDataFactory.create(D2DDKey(m_data->getUniqueID(),&m_data));
+  if ( m_sabfloat ) {
+    if ( !m_derivedData_float )
+      m_derivedData_float = s_SABData2DerivedDataFactory_float.create(D2DDKey(m_data->getUniqueID(),&m_data));
+  } else {
+    if ( !m_derivedData_double )
+      m_derivedData_double = s_SABData2DerivedDataFactory.create(D2DDKey(m_data->getUniqueID(),&m_data));
+  }
 
   const bool doSampler = out_sampler!=nullptr;
 
@@ -281,19 +341,26 @@ void NS::SABIntegrator::Impl::doit(SABXSProvider * out_xs, SABSampler* out_sampl
   setupEnergyGrid();
 
   std::vector<std::unique_ptr<SABSamplerAtE>> energyPointSamplers;
-  if ( doSampler )
-    energyPointSamplers.reserve(m_egrid.size());
   VectD xsvals;
-  xsvals.reserve(m_egrid.size());
 
-  for (const auto& energy : m_egrid ) {
-    nc_assert(energy>0.0);
-    auto sampleruptr_and_xs =  analyseEnergyPoint(energy, doSampler );
+  if ( m_egridmaxpts ) {
+    refineEnergyGrid( doSampler, xsvals, energyPointSamplers );
+  } else {
     if ( doSampler )
-      energyPointSamplers.emplace_back(std::move(sampleruptr_and_xs.first));
-    xsvals.emplace_back( sampleruptr_and_xs.second );
+      energyPointSamplers.reserve(m_egrid.size());
+    xsvals.reserve(m_egrid.size());
+    for (const auto& energy : m_egrid ) {
+      nc_assert(energy>0.0);
+      auto sampleruptr_and_xs =  analyseEnergyPoint(energy, doSampler );
+      if ( doSampler )
+        energyPointSamplers.emplace_back(std::move(sampleruptr_and_xs.first));
+      xsvals.emplace_back( sampleruptr_and_xs.second );
+    }
   }
 
+  if ( m_sabfloat == 2 )
+    reportFloatStorageDeviations( xsvals );
+
   if ( doSampler )
     out_sampler->setData( m_data->temperature(),
                           VectD(m_egrid.begin(),m_egrid.end()),
@@ -306,7 +373,167 @@ void NS::SABIntegrator::Impl::doit(SABXSProvider * out_xs, SABSampler* out_sampl
 
 }
 
-std::pair<NS::SABIntegrator::Impl::SamplerAtE_uptr,double> NS::SABIntegrator::Impl::analyseEnergyPoint(double ekin, bool doSampler ) const
+void NS::SABIntegrator::Impl::refineEnergyGrid( bool doSampler, VectD& xsvals,
+                                                std::vector<SamplerAtE_uptr>& samplers )
+{
+  //Adaptive refinement of the coarse grid in m_egrid. Each interval is tested
+  //by evaluating the cross section at its (geometric) midpoint and comparing
+  //with the linear interpolation used in SABXSProvider. Intervals failing the
+  //m_egridtol criteria are queued, and the worst ones accepted first (adding
+  //the already analysed midpoint to the grid and testing the two new
+  //intervals), until either all intervals pass or m_egridmaxpts points are
+  //reached. Midpoints of intervals which pass are simply discarded.
+  nc_assert_always( m_egridmaxpts >= m_egrid.size() && m_egrid.size() >= 2 );
+
+  struct EPoint {
+    double ekin;
+    double xs;
+    SamplerAtE_uptr sampler;
+  };
+  struct Candidate {
+    double relerr;
+    double e0, xs0, e1, xs1;
+    EPoint mid;
+  };
+  auto cmpCandidate = [](const Candidate& a, const Candidate& b) { return a.relerr < b.relerr; };
+
+  auto analysePoint = [this,doSampler](double ekin)
+  {
+    nc_assert(ekin>0.0);
+    auto sampleruptr_and_xs = analyseEnergyPoint( ekin, doSampler );
+    return EPoint{ ekin, sampleruptr_and_xs.second, std::move(sampleruptr_and_xs.first) };
+  };
+
+  std::vector<Candidate> queue;//heap ordered by relerr
+  auto testInterval = [this,&queue,&analysePoint,&cmpCandidate](double e0, double xs0, double e1, double xs1)
+  {
+    const double emid = std::sqrt( e0 * e1 );
+    if ( !(emid > e0) || !(emid < e1) )
+      return;//interval too narrow
+    EPoint mid = analysePoint( emid );
+    const double xs_interp = xs0 + ( xs1 - xs0 ) * ( ( emid - e0 ) / ( e1 - e0 ) );
+    const double scale = ncmax( ncabs( mid.xs ), ncabs( xs_interp ) );
+    const double relerr = scale > 0.0 ? ncabs( mid.xs - xs_interp ) / scale : 0.0;
+    if ( !( relerr > m_egridtol ) )
+      return;
+    queue.push_back( Candidate{ relerr, e0, xs0, e1, xs1, std::move(mid) } );
+    std::push_heap( queue.begin(), queue.end(), cmpCandidate );
+  };
+
+  std::vector<EPoint> points;
+  points.reserve( m_egridmaxpts );
+  for ( const auto& energy : m_egrid )
+    points.emplace_back( analysePoint( energy ) );
+  for ( std::size_t i = 1; i < points.size(); ++i )
+    testInterval( points[i-1].ekin, points[i-1].xs, points[i].ekin, points[i].xs );
+
+  while ( !queue.empty() && points.size() < m_egridmaxpts ) {
+    std::pop_heap( queue.begin(), queue.end(), cmpCandidate );
+    Candidate c = std::move( queue.back() );
+    queue.pop_back();
+    const double emid = c.mid.ekin;
+    const double xsmid = c.mid.xs;
+    points.emplace_back( std::move( c.mid ) );
+    //Interpolation errors scale quadratically with interval width, so the two
+    //new intervals are expected to have errors ~relerr/4. Only test them if
+    //that is not comfortably below the tolerance (saving evaluations of
+    //midpoints which would most likely just be discarded):
+    if ( c.relerr > 2.0 * m_egridtol ) {
+      testInterval( c.e0, c.xs0, emid, xsmid );
+      testInterval( emid, xsmid, c.e1, c.xs1 );
+    }
+  }
+  queue.clear();
+
+  std::sort( points.begin(), points.end(),
+             []( const EPoint& a, const EPoint& b ) { return a.ekin < b.ekin; } );
+  m_egrid.clear();
+  m_egrid.reserve( points.size() );
+  xsvals.clear();
+  xsvals.reserve( points.size() );
+  samplers.clear();
+  if ( doSampler )
+    samplers.reserve( points.size() );
+  for ( auto& p : points ) {
+    m_egrid.push_back( p.ekin );
+    xsvals.push_back( p.xs );
+    if ( doSampler )
+      samplers.emplace_back( std::move( p.sampler ) );
+  }
+  nc_assert_always( nc_is_grid( m_egrid ) );
+}
+
+void NS::SABIntegrator::Impl::reportFloatStorageDeviations( const VectD& xsvals_float )
+{
+  //Validation mode (sabfloat=2): Redo the analysis using double precision
+  //storage of the derived tables, and report how much the cross sections and
+  //sampled (alpha,beta) values obtained with single precision storage deviate.
+  nc_assert_always( m_sabfloat == 2 && !!m_derivedData_float );
+  nc_assert_always( xsvals_float.size() == m_egrid.size() );
+  auto dd_double = s_SABData2DerivedDataFactory.create(D2DDKey(m_data->getUniqueID(),&m_data));
+
+  double maxreldev_xs(0.0), maxreldev_xs_energy(0.0);
+  for ( std::size_t i = 0; i < m_egrid.size(); ++i ) {
+    const double xs_double = analyseEnergyPointImpl<double>( m_egrid.at(i), false, dd_double ).second;
+    const double xs_float = xsvals_float.at(i);
+    const double reldev = ( xs_double == xs_float ? 0.0 : ncabs(xs_float-xs_double)/ncmax(ncabs(xs_double),1e-300) );
+    if ( reldev > maxreldev_xs ) {
+      maxreldev_xs = reldev;
+      maxreldev_xs_energy = m_egrid.at(i);
+    }
+  }
+
+  //Sample (alpha,beta) with both storage types at a few energies, using
+  //identically seeded random streams:
+  const unsigned nenergies = 10;
+  const unsigned nsamples = 10000;
+  const double kT = constant_boltzmann * m_data->temperature();
+  double maxdev_alpha(0.0), maxdev_beta(0.0);
+  StableSum sumdev_alpha, sumdev_beta, sumshift_alpha, sumshift_beta;
+  std::size_t ntot(0);
+  for ( unsigned ie = 0; ie < nenergies; ++ie ) {
+    const double ekin = m_egrid.at( ( ie * ( m_egrid.size() - 1 ) ) / ( nenergies - 1 ) );
+    auto sampler_double = analyseEnergyPointImpl<double>( ekin, true, dd_double ).first;
+    auto sampler_float = analyseEnergyPointImpl<float>( ekin, true, m_derivedData_float ).first;
+    RCHolder<RandXRSR> rng_double(new RandXRSR(12345+ie));
+    RCHolder<RandXRSR> rng_float(new RandXRSR(12345+ie));
+    for ( unsigned is = 0; is < nsamples; ++is ) {
+      auto ab_double = sampler_double->sampleAlphaBeta( ekin/kT, *rng_double.obj() );
+      auto ab_float = sampler_float->sampleAlphaBeta( ekin/kT, *rng_float.obj() );
+      const double da = ab_float.first - ab_double.first;
+      const double db = ab_float.second - ab_double.second;
+      maxdev_alpha = ncmax( maxdev_alpha, ncabs(da) );
+      maxdev_beta = ncmax( maxdev_beta, ncabs(db) );
+      sumdev_alpha.add( ncabs(da) );
+      sumdev_beta.add( ncabs(db) );
+      sumshift_alpha.add( da );
+      sumshift_beta.add( db );
+      ++ntot;
+    }
+  }
+
+  const std::size_t nbytes_double = sizeof(double) * ( dd_double->logsab.size() + dd_double->alphaintegrals_cumul.size() );
+  const std::size_t nbytes_float = sizeof(float) * ( m_derivedData_float->logsab.size() + m_derivedData_float->alphaintegrals_cumul.size() );
+  const double ntotinv = 1.0 / ntot;
+  std::cout << "NCrystal: SAB single precision storage validation report (sabfloat=2) for table with "
+            << m_data->alphaGrid().size() << " x " << m_data->betaGrid().size() << " (alpha,beta) points at T="
+            << m_data->temperature() << "K:\n"
+            << "NCrystal:   Memory for derived tables: " << nbytes_float << " bytes (vs. "
+            << nbytes_double << " bytes with double precision storage).\n"
+            << "NCrystal:   Max relative cross section deviation on " << m_egrid.size()
+            << " point energy grid: " << maxreldev_xs << " (at E=" << maxreldev_xs_energy << "eV)\n"
+            << "NCrystal:   Sampled alpha deviations from " << ntot << " samples at " << nenergies
+            << " energies: max=" << maxdev_alpha << " mean=" << sumdev_alpha.sum()*ntotinv
+            << " mean shift=" << sumshift_alpha.sum()*ntotinv << "\n"
+            << "NCrystal:   Sampled beta deviations from " << ntot << " samples at " << nenergies
+            << " energies: max=" << maxdev_beta << " mean=" << sumdev_beta.sum()*ntotinv
+            << " mean shift=" << sumshift_beta.sum()*ntotinv << std::endl;
+}
+
+template<class TStorage>
+std::pair<NS::SABIntegrator::Impl::SamplerAtE_uptr,double>
+NS::SABIntegrator::Impl::analyseEnergyPointImpl( double ekin, bool doSampler,
+                                                 const DerivedDataPtr<TStorage>& derivedData ) const
 {
   nc_assert_always(ekin>0.0);
 
@@ -324,9 +551,9 @@ std::pair<NS::SABIntegrator::Impl::SamplerAtE_uptr,double> NS::SABIntegrator::Im
 
   const auto& betaGrid = m_data->betaGrid();
   auto alphaGrid_span = span<const double>(m_data->alphaGrid());
-  nc_assert(!!m_derivedData);
-  const VectD& logsab = m_derivedData->logsab;
-  const VectD& alphaintegrals_cumul = m_derivedData->alphaintegrals_cumul;
+  nc_assert(!!derivedData);
+  const std::vector<TStorage>& logsab = derivedData->logsab;
+  const std::vector<TStorage>& alphaintegrals_cumul = derivedData->alphaintegrals_cumul;
 
   nc_assert(ekin>=0.);
   const double kT = constant_boltzmann * m_data->temperature();
@@ -376,7 +603,7 @@ std::pair<NS::SABIntegrator::Impl::SamplerAtE_uptr,double> NS::SABIntegrator::Im
   PairDD prev_betaxs(beta_lower_limit,0.);
   std::vector<PairDD> betasampler_data;
   VectD betasampler_vals,betasampler_weights;
-  std::vector<SABSamplerAtE_Alg1::AlphaSampleInfo> sampler_infos;
+  std::vector<SABAlphaSampleInfo> sampler_infos;
   const std::size_t nsamplervals = ( doSampler ? relevant_betaGrid.size()+1 : 0 );
   if (doSampler) {
     betasampler_vals.reserve( nsamplervals );
@@ -410,10 +637,11 @@ std::pair<NS::SABIntegrator::Impl::SamplerAtE_uptr,double> NS::SABIntegrator::Im
       const auto nalpha = m_data->alphaGrid().size();
       auto slice_idx = nalpha*(beta.idx + ibeta_low);
       auto sab_slice = span<const double>(&m_data->sab()[0]+slice_idx,&m_data->sab()[0]+slice_idx+nalpha);
-      auto logsab_slice = span<const double>(&logsab[0]+slice_idx,&logsab[0]+slice_idx+nalpha);
-      auto alphaIntegrals_cumul_slice = span<const double>(&alphaintegrals_cumul[0]+slice_idx,&alphaintegrals_cumul[0]+slice_idx+nalpha);
-      tb = SABUtils::createTailedBreakdown( alphaGrid_span, sab_slice, logsab_slice, alphaIntegrals_cumul_slice,
-                                            alow, aupp, aidx_low, aidx_upp );
+      const std::size_t ibeta_global = beta.idx + ibeta_low;
+      auto logsab_slice = SABUtils::sliceTableAtBetaIdx(logsab,nalpha,ibeta_global);
+      auto alphaIntegrals_cumul_slice = SABUtils::sliceTableAtBetaIdx(alphaintegrals_cumul,nalpha,ibeta_global);
+      tb = SABUtils::createTailedBreakdown<TStorage>( alphaGrid_span, sab_slice, logsab_slice, alphaIntegrals_cumul_slice,
+                                                      alow, aupp, aidx_low, aidx_upp );
       xs_at_this_beta = tb.xs_front + tb.xs_back + tb.xs_middle;
     } else {
       //No cross-section here!
@@ -474,11 +702,11 @@ std::pair<NS::SABIntegrator::Impl::SamplerAtE_uptr,double> NS::SABIntegrator::Im
   if ( xs_total == 0.0 )
     return { std::make_unique<SABSamplerAtE_NoScatter>(), xs_total };
 
-  nc_assert(!!m_derivedData);
-  SamplerAtE_uptr up = std::make_unique<SABSamplerAtE_Alg1>( m_derivedData,
-                                                             std::move(betasampler_vals),
-                                                             std::move(betasampler_weights),
-                                                             std::move(sampler_infos),
-                                                             ibeta_low );
+  SamplerAtE_uptr up = std::make_unique<SABSamplerAtE_Alg1<TStorage>>( derivedData,
+                                                                       std::move(betasampler_vals),
+                                                                       std::move(betasampler_weights),
+                                                                       std::move(sampler_infos),
+                                                                       ibeta_low,
+                                                                       m_nalphatab );
   return { std::move(up), xs_total };
 }
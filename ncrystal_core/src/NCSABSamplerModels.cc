@@ -23,11 +23,13 @@
 #include "NCrystal/internal/NCString.hh"
 namespace NC = NCrystal;
 
-NC::SAB::SABSamplerAtE_Alg1::SABSamplerAtE_Alg1( std::shared_ptr<const CommonCache> common,
-                                                 VectD&& betaVals,
-                                                 VectD&& betaWeights,
-                                                 std::vector<AlphaSampleInfo>&& alphaSamplerInfos,
-                                                 std::size_t ibetaOffset )
+template<class TStorage>
+NC::SAB::SABSamplerAtE_Alg1<TStorage>::SABSamplerAtE_Alg1( std::shared_ptr<const CommonCache> common,
+                                                           VectD&& betaVals,
+                                                           VectD&& betaWeights,
+                                                           std::vector<AlphaSampleInfo>&& alphaSamplerInfos,
+                                                           std::size_t ibetaOffset,
+                                                           unsigned nalphatab )
   : m_common( std::move(common) ),
     m_betaSampler(VectD(betaVals.begin(),betaVals.end()),
                   VectD(betaWeights.begin(),betaWeights.end()) ),
@@ -40,9 +42,36 @@ NC::SAB::SABSamplerAtE_Alg1::SABSamplerAtE_Alg1( std::shared_ptr<const CommonCac
   //+1 in the next two asserts since vals,weights starts with (beta_lower,0.0):
   nc_assert( m_alphaSamplerInfos.size()+1 == betaVals.size() );
   nc_assert( ibetaOffset+betaVals.size() == m_common->data->betaGrid().size()+1 );
+  if ( nalphatab )
+    initAlphaTables( nalphatab );
 }
 
-NC::PairDD NC::SAB::SABSamplerAtE_Alg1::sampleAlphaBeta(double ekin_div_kT, RandomBase&rng) const
+template<class TStorage>
+void NC::SAB::SABSamplerAtE_Alg1<TStorage>::initAlphaTables( unsigned nalphatab )
+{
+  //Evaluate the inverse CDF of each beta column at nalphatab equidistant
+  //percentiles in [0,1]. Tables are only filled here, so m_nalphatab must be
+  //kept at 0 until they are complete:
+  nc_assert_always( nalphatab >= 2 );
+  const std::size_t ncols = m_alphaSamplerInfos.size();
+  m_alphaTables.clear();
+  m_alphaTables.reserve( ncols * nalphatab );
+  const double dp = 1.0 / ( nalphatab - 1 );
+  for ( std::size_t icol = 0; icol < ncols; ++icol ) {
+    for ( unsigned i = 0; i < nalphatab; ++i ) {
+      //percentile 0 is avoided, since it would divide 0 by 0 for info objects
+      //with vanishing prob_front:
+      const double p = ( i == 0 ? std::numeric_limits<double>::min()
+                                : ( i + 1 == nalphatab ? 1.0 : i * dp ) );
+      m_alphaTables.push_back( static_cast<TStorage>( sampleAlphaFromInfo( m_ibetaOffset + icol, p ) ) );
+    }
+  }
+  m_alphaTables.shrink_to_fit();
+  m_nalphatab = nalphatab;
+}
+
+template<class TStorage>
+NC::PairDD NC::SAB::SABSamplerAtE_Alg1<TStorage>::sampleAlphaBeta(double ekin_div_kT, RandomBase&rng) const
 {
   nc_assert(!!m_common);
   const auto& betaGrid = m_common->data->betaGrid();
@@ -121,21 +150,45 @@ NC::PairDD NC::SAB::SABSamplerAtE_Alg1::sampleAlphaBeta(double ekin_div_kT, Rand
                   " (but please consider reporting the issue to the NCrystal developers nonetheless).");
 }
 
-double NC::SAB::SABSamplerAtE_Alg1::sampleBeta(RandomBase& rng) const
+template<class TStorage>
+double NC::SAB::SABSamplerAtE_Alg1<TStorage>::sampleBeta(RandomBase& rng) const
 {
   return m_betaSampler.sample(rng);
 }
 
-double NC::SAB::SABSamplerAtE_Alg1::sampleAlpha(std::size_t ibeta, double rand_percentile) const
+template<class TStorage>
+double NC::SAB::SABSamplerAtE_Alg1<TStorage>::sampleAlpha(std::size_t ibeta, double rand_percentile) const
+{
+  if ( !m_nalphatab )
+    return sampleAlphaFromInfo( ibeta, rand_percentile );
+
+  //Direct inversion of tabulated CDF:
+  nc_assert( ibeta >= m_ibetaOffset );
+  nc_assert( rand_percentile >= 0.0 && rand_percentile <= 1.0 );
+  const TStorage * tab = &m_alphaTables[ ( ibeta - m_ibetaOffset ) * m_nalphatab ];
+  nc_assert( tab + m_nalphatab <= m_alphaTables.data() + m_alphaTables.size() );
+  const double x = rand_percentile * ( m_nalphatab - 1 );
+  const unsigned i = ncmin( static_cast<unsigned>( x ), m_nalphatab - 2 );
+  const double a0 = tab[i];
+  const double a1 = tab[i+1];
+  return ncmax( 0.0, a0 + ( x - i ) * ( a1 - a0 ) );
+}
+
+template<class TStorage>
+double NC::SAB::SABSamplerAtE_Alg1<TStorage>::sampleAlphaFromInfo(std::size_t ibeta, double rand_percentile) const
 {
   nc_assert( ibeta >= m_ibetaOffset );
   const auto& info = vectAt(m_alphaSamplerInfos,ibeta-m_ibetaOffset);
 
   const auto& cd = m_common->data;
   auto nalpha = cd->alphaGrid().size();
-  auto cumul = SABUtils::sliceSABAtBetaIdx_const(m_common->alphaintegrals_cumul,nalpha,ibeta);
+  auto cumul = SABUtils::sliceTableAtBetaIdx(m_common->alphaintegrals_cumul,nalpha,ibeta);
   auto sab = SABUtils::sliceSABAtBetaIdx_const(cd->sab(),nalpha,ibeta);
-  auto logsab = SABUtils::sliceSABAtBetaIdx_const(m_common->logsab,nalpha,ibeta);
+  auto logsab = SABUtils::sliceTableAtBetaIdx(m_common->logsab,nalpha,ibeta);
+  auto logsabAt = [&sab,&logsab](std::size_t i) -> double
+                  {
+                    return logsab.empty() ? SABUtils::logSVal(span_at(sab,i)) : span_at(logsab,i);
+                  };
   auto clampRandNum = [](double r) { return ncclamp( r, std::numeric_limits<double>::min(), 1.0 ); };//ensure r is in (0,1]
   auto clampUnitInterval = [](double r) { return ncclamp( r, 0.0, 1.0 ); };//ensure r is in [0,1]
 
@@ -158,7 +211,7 @@ double NC::SAB::SABSamplerAtE_Alg1::sampleAlpha(std::size_t ibeta, double rand_p
       return SABUtils::sampleLogLinDist_fast( info.pt_front.alpha, info.pt_front.sval,
                                               vectAt(cd->alphaGrid(),info.pt_front.alpha_idx), span_at(sab,info.pt_front.alpha_idx),
                                               percentile2,
-                                              info.pt_front.logsval, span_at(logsab,info.pt_front.alpha_idx) );
+                                              info.pt_front.logsval, logsabAt(info.pt_front.alpha_idx) );
     }
   } else if ( rand_percentile <= info.prob_notback ) {
     //Middle section - sample over entire alpha bins.
@@ -191,7 +244,7 @@ double NC::SAB::SABSamplerAtE_Alg1::sampleAlpha(std::size_t ibeta, double rand_p
     return SABUtils::sampleLogLinDist_fast( vectAt(cd->alphaGrid(),a0), span_at(sab,a0),
                                             vectAt(cd->alphaGrid(),a1), span_at(sab,a1),
                                             rand_rescaled,
-                                            span_at(logsab,a0), span_at(logsab,a1) );
+                                            logsabAt(a0), logsabAt(a1) );
   } else {
     //Sample back tail
     nc_assert( 1.0 - info.prob_notback > 0.0 );
@@ -199,8 +252,15 @@ double NC::SAB::SABSamplerAtE_Alg1::sampleAlpha(std::size_t ibeta, double rand_p
     return SABUtils::sampleLogLinDist_fast( vectAt(cd->alphaGrid(),info.pt_back.alpha_idx), span_at(sab,info.pt_back.alpha_idx),
                                             info.pt_back.alpha, info.pt_back.sval,
                                             percentile2,
-                                            span_at(logsab,info.pt_back.alpha_idx), info.pt_back.logsval );
+                                            logsabAt(info.pt_back.alpha_idx), info.pt_back.logsval );
 
   }
 
 }
+
+namespace NCrystal {
+  namespace SAB {
+    template class SABSamplerAtE_Alg1<double>;
+    template class SABSamplerAtE_Alg1<float>;
+  }
+}
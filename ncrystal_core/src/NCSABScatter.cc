@@ -47,16 +47,24 @@ NC::SABScatter::SABScatter( NC::SAB::SABScatterHelper&& sh )
 {
 }
 
-NC::SABScatter::SABScatter( const DI_ScatKnl& di_sk, unsigned vdoslux, bool useCache )
-  : SABScatter( [&di_sk,vdoslux,useCache]()
+NC::SABScatter::SABScatter( const DI_ScatKnl& di_sk, unsigned vdoslux, bool useCache,
+                            unsigned sabfloat, double egridtol, unsigned nalphatab,
+                            double tempinterp )
+  : SABScatter( [&di_sk,vdoslux,useCache,sabfloat,egridtol,nalphatab,tempinterp]()
                 {
-                  auto sabdata_ptr = extractSABDataFromDynInfo(&di_sk,vdoslux,useCache);
+                  auto sabdata_ptr = extractSABDataFromDynInfo(&di_sk,vdoslux,useCache,tempinterp);
                   nc_assert_always(!!sabdata_ptr);
                   return ( useCache
                            ? SAB::createScatterHelperWithCache( std::move(sabdata_ptr),
-                                                                di_sk.energyGrid() )
+                                                                di_sk.energyGrid(),
+                                                                sabfloat,
+                                                                egridtol,
+                                                                nalphatab )
                            : SAB::createScatterHelper( std::move(sabdata_ptr),
-                                                       di_sk.energyGrid() ) );
+                                                       di_sk.energyGrid(),
+                                                       sabfloat,
+                                                       egridtol,
+                                                       nalphatab ) );
                 }() )
 {
 }
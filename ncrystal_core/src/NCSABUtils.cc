@@ -356,10 +356,11 @@ void NC::SABUtils::activeGridRanges( const NC::SABData& data,
 
 }
 
+template<class TStorage>
 NC::SABUtils::TailedBreakdown NC::SABUtils::createTailedBreakdown( const span<const double>& alphaGrid,
                                                                    const span<const double>& sab,
-                                                                   const span<const double>& logsab,
-                                                                   const span<const double>& alphaIntegrals_cumul,
+                                                                   const span<const TStorage>& logsab,
+                                                                   const span<const TStorage>& alphaIntegrals_cumul,
                                                                    double alpha_low, double alpha_upp,
                                                                    const unsigned aidx_low, const unsigned aidx_upp )
 {
@@ -383,7 +384,11 @@ NC::SABUtils::TailedBreakdown NC::SABUtils::createTailedBreakdown( const span<co
   nc_assert( aidx_low+1==alphaGrid.size() || alpha_low < span_at(alphaGrid,aidx_low+1) );
   nc_assert( aidx_upp==0 || alpha_upp > span_at(alphaGrid,aidx_upp-1) );
 
-  auto interpSVal = [&alphaGrid,&sab,&logsab](const std::size_t alphaidx_lowedge, const double alpha)
+  auto logsabAt = [&sab,&logsab](std::size_t i) -> double
+                  {
+                    return logsab.empty() ? logSVal(span_at(sab,i)) : span_at(logsab,i);
+                  };
+  auto interpSVal = [&alphaGrid,&sab,&logsabAt](const std::size_t alphaidx_lowedge, const double alpha)
                     {
                       nc_assert( alphaidx_lowedge + 1 < (unsigned)alphaGrid.size() );
                       const double alpha0(span_at(alphaGrid,alphaidx_lowedge));
@@ -391,13 +396,13 @@ NC::SABUtils::TailedBreakdown NC::SABUtils::createTailedBreakdown( const span<co
                       nc_assert( valueInInterval(alpha0,alpha1,alpha) );
                       auto i0(alphaidx_lowedge), i1(alphaidx_lowedge+1);
                       return interpolate_loglin_fallbacklinlin_fast(alpha0,span_at(sab,i0),alpha1,span_at(sab,i1),alpha,
-                                                                    span_at(logsab,i0),span_at(logsab,i1));
+                                                                    logsabAt(i0),logsabAt(i1));
                     };
   auto setTailPoint = [&interpSVal](TailedBreakdown::TailPoint& tp,unsigned aidx,double alpha)
                       {
                         tp.alpha = alpha;
                         tp.sval = interpSVal(aidx,alpha);
-                        tp.logsval = tp.sval > 0.0 ? std::log(tp.sval) : -kInfinity;
+                        tp.logsval = logSVal(tp.sval);
                       };
 
   //Enough setting up, time to analyse the tails and how they fall wrt the grid:
@@ -423,7 +428,7 @@ NC::SABUtils::TailedBreakdown NC::SABUtils::createTailedBreakdown( const span<co
     setTailPoint(tb.front,aidx_low,alpha_low);
     tb.xs_front = integrateAlphaInterval_fast( tb.front.alpha, tb.front.sval,
                                                span_at(alphaGrid,aidx_low+1), span_at(sab,aidx_low+1),
-                                               tb.front.logsval, span_at(logsab,aidx_low+1) );
+                                               tb.front.logsval, logsabAt(aidx_low+1) );
     ++tb.imiddle_low;
   }
   //Back (not there if alpha_upp is outside the grid range):
@@ -433,7 +438,7 @@ NC::SABUtils::TailedBreakdown NC::SABUtils::createTailedBreakdown( const span<co
     setTailPoint(tb.back,aidx_upp-1,alpha_upp);
     tb.xs_back = integrateAlphaInterval_fast( span_at(alphaGrid,aidx_upp-1), span_at(sab,aidx_upp-1),
                                               tb.back.alpha, tb.back.sval,
-                                              span_at(logsab,aidx_upp-1), tb.back.logsval );
+                                              logsabAt(aidx_upp-1), tb.back.logsval );
     --tb.imiddle_upp;
   }
   tb.xs_middle = ( tb.imiddle_upp > tb.imiddle_low ?
@@ -441,3 +446,14 @@ NC::SABUtils::TailedBreakdown NC::SABUtils::createTailedBreakdown( const span<co
                    : 0.0 );
   return tb;
 }
+
+namespace NCrystal {
+  namespace SABUtils {
+    template TailedBreakdown createTailedBreakdown<double>( const span<const double>&, const span<const double>&,
+                                                            const span<const double>&, const span<const double>&,
+                                                            double, double, const unsigned, const unsigned );
+    template TailedBreakdown createTailedBreakdown<float>( const span<const double>&, const span<const double>&,
+                                                           const span<const float>&, const span<const float>&,
+                                                           double, double, const unsigned, const unsigned );
+  }
+}
@@ -40,7 +40,7 @@ struct NC::SCBragg::pimpl {
 
     //A familiy is here taken to be all planes sharing d-spacing and fsquared.
 
-    std::vector<Vector> deminormals;
+    GaussMos::DemiNormals deminormals;//lab frame, stored as SoA
     double xsfact;// = fsquared / (unit_cell_volume * unit_cell_natoms)
     double inv2d;
 
@@ -350,3 +350,14 @@ void NC::SCBragg::generateScattering( double ekin, const double (&indir)[3],
 
   m_pimpl->genScat(this,asVect(outdir));
 }
+
+const NC::GaussMos& NC::SCBragg::gaussMos() const
+{
+  return m_pimpl->m_gm;
+}
+
+void NC::SCBragg::visitReflectionFamilies( const FamilyVisitor& visitor ) const
+{
+  for ( auto& fam : m_pimpl->m_reflfamilies )
+    visitor( fam.inv2d, fam.xsfact, fam.deminormals.toVector() );
+}
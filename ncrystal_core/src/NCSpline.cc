@@ -68,6 +68,34 @@ void NCrystal::CubicSpline::set( const VectD& y,
   m_nm2 = n-2;
 }
 
+void NCrystal::SplinedLookupTable::eval( span<const double> x, span<double> out ) const
+{
+  //Same as the scalar eval (thus with bitwise identical results), but without
+  //per-call overhead and with a loop body which can be vectorised:
+  nc_assert_always( x.size() == out.size() );
+  nc_assert( m_spline.m_nm2 > 0 );
+  const std::size_t n = x.size();
+  const std::size_t nm2 = m_spline.m_nm2;
+  const PairDD * data = m_spline.m_data.data();
+  const double a0 = m_a;
+  const double invdelta = m_invdelta;
+  const double * xx = x.data();
+  double * oo = out.data();
+  for ( std::size_t i = 0; i < n; ++i ) {
+    const double u = ( xx[i] - a0 ) * invdelta;
+    const std::size_t idx = ncmin( static_cast<std::size_t>(u), nm2 );
+    const double b = u - idx;
+    const double a = 1.0 - b;
+    const PairDD& p0 = data[idx];
+    const PairDD& p1 = data[idx+1];
+    double tmp = a * p0.first;
+    double tmp2 = ( a*a*a - a ) * p0.second;
+    tmp += b * p1.first;
+    tmp2 += ( b*b*b - b ) * p1.second;
+    oo[i] = tmp + 0.166666666666666666666666666666666666666666666666666667 * tmp2;
+  }
+}
+
 void NCrystal::SplinedLookupTable::set( const VectD& fvals,
                                         double a,double b,
                                         double fprime_a, double fprime_b,
@@ -140,7 +140,8 @@ namespace NCrystal {
             double lcdir[3];
             cfg.get_lcaxis(lcdir);
             sc->addComponent(new LCBragg( info.obj(), sco, cfg.get_mos(), lcdir, cfg.get_lcmode(),
-                                        0,sc_pp.get(),cfg.get_mosprec(),0.0));
+                                          0,sc_pp.get(),cfg.get_mosprec(),0.0,cfg.get_lctabprec(),
+                                          cfg.get_lcrotseed()));
           } else {
             sc->addComponent(new SCBragg( info.obj(), sco,cfg.get_mos(),0.0,sc_pp.get(),cfg.get_mosprec(),0.));
           }
@@ -188,7 +189,9 @@ namespace NCrystal {
           for (auto& di : info->getDynamicInfoList()) {
             const DI_ScatKnl* di_scatknl = dynamic_cast<const DI_ScatKnl*>(di.get());
             if (di_scatknl) {
-              sc->addComponent( new SABScatter( *di_scatknl, cfg.get_vdoslux() ), di->fraction() );
+              sc->addComponent( new SABScatter( *di_scatknl, cfg.get_vdoslux(), true,
+                                                cfg.get_sabfloat(), cfg.get_sabegridtol(),
+                                                cfg.get_sabalphatab(), cfg.get_sabtempinterp() ), di->fraction() );
             } else if (dynamic_cast<const DI_Sterile*>(di.get())) {
               continue;//just skip past sterile components
             } else if (dynamic_cast<const DI_FreeGas*>(di.get())) {
@@ -222,7 +225,9 @@ namespace NCrystal {
                                                               it->atom.data().scatteringXS(),
                                                               it->atom.data().averageMassAMU(),
                                                               cfg.get_vdoslux() );
-            auto scathelper = SAB::createScatterHelperWithCache( std::move(sabdata) );
+            auto scathelper = SAB::createScatterHelperWithCache( std::move(sabdata), nullptr,
+                                                                 cfg.get_sabfloat(), cfg.get_sabegridtol(),
+                                                                 cfg.get_sabalphatab() );
             sc->addComponent( new SABScatter( std::move(scathelper) ), it->number_per_unit_cell*1.0/ntot );
           }
         }
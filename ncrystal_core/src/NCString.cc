@@ -21,6 +21,7 @@
 #include "NCrystal/internal/NCString.hh"
 #include "NCrystal/internal/NCMath.hh"
 #include <cstring>
+#include <cfloat>
 #include <istream>
 #include <iomanip>
 namespace NC = NCrystal;
@@ -174,8 +175,112 @@ int NC::str2int(const std::string& s,const char * errmsg)
   return result;
 }
 
+namespace NCrystal {
+  namespace {
+    bool fast_str2dbl( const char * c, const char * cE, double& result )
+    {
+      //Implements the "fast path" of Clinger (1990): If the decimal mantissa,
+      //w, is an integer exactly representable in a double (w<=2^53), and the
+      //exponent is such that 10^|e| is also exactly representable (|e|<=22),
+      //a single IEEE multiplication or division gives the correctly rounded
+      //result of w*10^e. Returns false for anything else (in which case the
+      //input might or might not be a valid number).
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+      static const double exact_pow10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+                                            1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19,
+                                            1e20, 1e21, 1e22 };
+      while ( c != cE && isOneOf(*c,' ','\t','\n') )
+        ++c;
+      while ( cE != c && isOneOf(*(cE-1),' ','\t','\n') )
+        --cE;
+      if ( c == cE )
+        return false;
+      bool negative = false;
+      if ( *c == '-' || *c == '+' ) {
+        negative = ( *c == '-' );
+        ++c;
+      }
+      uint64_t mantissa = 0;
+      unsigned ndigits = 0;//significant digits (i.e. excluding leading zeroes)
+      bool anydigits = false;
+      bool afterpoint = false;
+      int exponent = 0;
+      for ( ; c != cE; ++c ) {
+        if ( *c == '.' ) {
+          if ( afterpoint )
+            return false;
+          afterpoint = true;
+          continue;
+        }
+        const unsigned digit = static_cast<unsigned>( *c - '0' );
+        if ( digit > 9 )
+          break;
+        anydigits = true;
+        if ( mantissa || digit ) {
+          if ( ++ndigits > 19 )
+            return false;
+          mantissa = mantissa * 10 + digit;
+        }
+        if ( afterpoint )
+          --exponent;
+      }
+      if ( !anydigits )
+        return false;
+      if ( c != cE ) {
+        if ( *c != 'e' && *c != 'E' )
+          return false;
+        if ( ++c == cE )
+          return false;
+        bool negexp = false;
+        if ( *c == '-' || *c == '+' ) {
+          negexp = ( *c == '-' );
+          if ( ++c == cE )
+            return false;
+        }
+        int expval = 0;
+        for ( ; c != cE; ++c ) {
+          const unsigned digit = static_cast<unsigned>( *c - '0' );
+          if ( digit > 9 || expval > 10000 )
+            return false;
+          expval = expval * 10 + digit;
+        }
+        exponent += ( negexp ? -expval : expval );
+      }
+      if ( !mantissa ) {
+        result = negative ? -0.0 : 0.0;
+        return true;
+      }
+      if ( mantissa > ( uint64_t(1) << 53 ) || exponent < -22 || exponent > 22 )
+        return false;
+      double val = static_cast<double>( mantissa );
+      if ( exponent < 0 )
+        val /= exact_pow10[-exponent];
+      else
+        val *= exact_pow10[exponent];
+      result = negative ? -val : val;
+      return true;
+#else
+      //Intermediate results might be kept in extended precision, meaning that
+      //rounding can not be guaranteed to be correct.
+      (void)c; (void)cE; (void)result;
+      return false;
+#endif
+    }
+  }
+}
+
+bool NC::safe_str2dbl(const char * begin, const char * end, double& result )
+{
+  nc_assert( begin && end >= begin );
+  if ( fast_str2dbl(begin,end,result) )
+    return true;
+  return safe_str2dbl(std::string(begin,end-begin),result);
+}
+
 bool NC::safe_str2dbl(const std::string& s, double& result )
 {
+  if ( fast_str2dbl(s.c_str(),s.c_str()+s.size(),result) )
+    return true;
   bool ok(true);
   double val;
   std::stringstream ss(s);
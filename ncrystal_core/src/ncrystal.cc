@@ -32,8 +32,14 @@
 #include "NCrystal/internal/NCAtomUtils.hh"
 #include "NCrystal/internal/NCAtomDB.hh"
 #include <cstring>
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
+#include <cstdint>
+#include <iterator>
+#include <mutex>
+#include <set>
+#include <atomic>
 
 namespace NCrystal {
 
@@ -155,6 +161,154 @@ namespace NCrystal {
     AtomWrapper * extract_atomwrapper(ncrystal_atomdata_t o) {
       return doExtract<AtomWrapper,ncrystal_atomdata_t>(o);
     }
+
+    //Opt-in memo of the last few cross section queries, kept per process handle
+    //and per thread (so no locking is needed on lookups). Processes are
+    //identified by their unique ID rather than their address, so a memo can
+    //never hand out values belonging to a deleted object whose memory was
+    //reused. Inputs are compared bitwise, so only exactly repeated neutron
+    //states are served from the memo and results are identical to an actual
+    //evaluation.
+    //
+    //When a process is deleted via ncrystal_unref, only the memo of the calling
+    //thread can be discarded directly. Memos on other threads are purged lazily:
+    //the IDs of processes with memos on any thread are kept in a global
+    //registry, and deletions bump a global generation counter. A thread seeing
+    //a new generation at its next memo lookup drops memos of processes no
+    //longer in the registry.
+    struct XSMemo {
+      struct Entry {
+        std::uint64_t key[4];//bits of ekin and direction
+        int oriented;
+        double xs;
+      };
+      std::uint64_t uid;
+      unsigned nused = 0;
+      unsigned next = 0;
+      std::vector<Entry> entries;//ring buffer of fixed capacity
+    };
+    static constexpr unsigned xsmemo_maxentries = 64;
+    //Number of memos on this thread (trivial thread_local, so the check in
+    //the no-memo fast path avoids any TLS initialisation guard):
+    static thread_local unsigned tl_nxsmemos = 0;
+    static thread_local std::vector<XSMemo> tl_xsmemos;
+    static thread_local unsigned tl_xsmemo_generation = 0;
+
+    struct XSMemoRegistry {
+      std::mutex mtx;
+      std::set<std::uint64_t> uids;//processes with memos on any thread
+      std::atomic<unsigned> nuids{0};//uids.size(), for lock-free checks
+      std::atomic<unsigned> generation{0};//incremented when uids are removed
+    };
+    XSMemoRegistry& xsMemoRegistry() {
+      static XSMemoRegistry reg;
+      return reg;
+    }
+
+    void purgeStaleXSMemos() {
+      auto& reg = xsMemoRegistry();
+      std::lock_guard<std::mutex> guard(reg.mtx);
+      tl_xsmemo_generation = reg.generation.load();
+      tl_xsmemos.erase( std::remove_if( tl_xsmemos.begin(), tl_xsmemos.end(),
+                                        [&reg](const XSMemo& m){ return !reg.uids.count(m.uid); } ),
+                        tl_xsmemos.end() );
+      tl_nxsmemos = static_cast<unsigned>(tl_xsmemos.size());
+    }
+
+    XSMemo * findXSMemo(const Process* p) {
+      if (!tl_nxsmemos)
+        return nullptr;
+      if ( tl_xsmemo_generation != xsMemoRegistry().generation.load(std::memory_order_relaxed) ) {
+        purgeStaleXSMemos();
+        if (!tl_nxsmemos)
+          return nullptr;
+      }
+      const std::uint64_t uid = p->getUniqueID().value;
+      for (auto& m : tl_xsmemos)
+        if ( m.uid == uid )
+          return &m;
+      return nullptr;
+    }
+
+    void setXSMemo(const Process* p, unsigned n) {
+      if ( n > xsmemo_maxentries )
+        NCRYSTAL_THROW2(BadInput,"Requested number of memoised cross section queries ("<<n
+                        <<") exceeds maximum of "<<xsmemo_maxentries);
+      const std::uint64_t uid = p->getUniqueID().value;
+      auto it = std::find_if(tl_xsmemos.begin(),tl_xsmemos.end(),
+                             [uid](const XSMemo& m){ return m.uid == uid; });
+      if ( !n ) {
+        if ( it != tl_xsmemos.end() )
+          tl_xsmemos.erase(it);
+      } else {
+        if ( it == tl_xsmemos.end() ) {
+          auto& reg = xsMemoRegistry();
+          {
+            std::lock_guard<std::mutex> guard(reg.mtx);
+            reg.uids.insert(uid);
+            reg.nuids = static_cast<unsigned>(reg.uids.size());
+          }
+          tl_xsmemos.emplace_back();
+          it = std::prev(tl_xsmemos.end());
+          it->uid = uid;
+        }
+        it->entries.clear();
+        it->entries.resize(n);
+        it->nused = 0;
+        it->next = 0;
+      }
+      tl_nxsmemos = static_cast<unsigned>(tl_xsmemos.size());
+    }
+
+    void forgetXSMemo(const Process* p) {
+      //Process is about to be deleted, remove it from the registry (so other
+      //threads will purge their memos) and discard any memo on this thread:
+      const std::uint64_t uid = p->getUniqueID().value;
+      auto& reg = xsMemoRegistry();
+      {
+        std::lock_guard<std::mutex> guard(reg.mtx);
+        if ( reg.uids.erase(uid) ) {
+          reg.nuids = static_cast<unsigned>(reg.uids.size());
+          ++reg.generation;
+        }
+      }
+      if ( tl_nxsmemos )
+        purgeStaleXSMemos();
+    }
+
+    inline void xsMemoKey( std::uint64_t (&key)[4], double ekin, const double* dir ) {
+      std::memcpy(&key[0],&ekin,sizeof(double));
+      if (dir) {
+        std::memcpy(&key[1],dir,3*sizeof(double));
+      } else {
+        key[1] = key[2] = key[3] = 0;
+      }
+    }
+
+    template<class TFct>
+    double memoisedXS( const Process* p, double ekin, const double* dir, TFct calc ) {
+      XSMemo * memo = findXSMemo(p);
+      if (!memo)
+        return calc();
+      std::uint64_t key[4];
+      xsMemoKey(key,ekin,dir);
+      const int oriented = dir ? 1 : 0;
+      for ( unsigned i = 0; i < memo->nused; ++i ) {
+        const XSMemo::Entry& e = memo->entries[i];
+        if ( e.oriented == oriented && std::memcmp(e.key,key,sizeof(key)) == 0 )
+          return e.xs;
+      }
+      const double xs = calc();
+      XSMemo::Entry& e = memo->entries[memo->next];
+      std::memcpy(e.key,key,sizeof(key));
+      e.oriented = oriented;
+      e.xs = xs;
+      if ( ++memo->next == memo->entries.size() )
+        memo->next = 0;
+      if ( memo->nused < memo->entries.size() )
+        ++memo->nused;
+      return xs;
+    }
   }
 }
 
@@ -260,8 +414,15 @@ void ncrystal_unref(void* o)
   try {
     NC::RCBase* rcb = ncc::extract_rcbase(o);
     unsigned rc = rcb->refCount();
-    if (rc==1)
+    if (rc==1) {
+      //Object is about to be deleted, discard any memos of it:
+      if ( ncc::xsMemoRegistry().nuids.load(std::memory_order_relaxed) ) {
+        const NC::Process * process = dynamic_cast<const NC::Process*>(rcb);
+        if (process)
+          ncc::forgetXSMemo(process);
+      }
       ncc::internal(o) = 0;//make sure passed ncrystal_xxx_t is now invalid
+    }
     rcb->unref();
   } NCCATCH;
 }
@@ -428,6 +589,17 @@ void ncrystal_info_gethkl( ncrystal_info_t ci_t, int idx,
   }
   try {
     NC::Info * ci = ncc::extract_info(ci_t);
+    if (ci->hasHKLArrays()) {
+      const NC::HKLArrays& arr = ci->hklArrays();
+      nc_assert(idx>=0&&(std::size_t)idx<arr.size());
+      *h = arr.h[idx];
+      *k = arr.k[idx];
+      *l = arr.l[idx];
+      *multiplicity = arr.multiplicity[idx];
+      *dspacing = arr.dspacing[idx];
+      *fsquared = arr.fsquared[idx];
+      return;
+    }
     NC::HKLList::const_iterator it = ci->hklBegin() + idx;
     nc_assert(it<ci->hklEnd());
     *h = it->h;
@@ -439,6 +611,124 @@ void ncrystal_info_gethkl( ncrystal_info_t ci_t, int idx,
   } NCCATCH;
 }
 
+void ncrystal_info_gethkl_all( ncrystal_info_t ci_t,
+                               int* h, int* k, int* l, int* multiplicity,
+                               double * dspacing, double* fsquared )
+{
+  if (!ncrystal_valid(&ci_t)) {
+    ncc::setError("ncrystal_info_gethkl_all called with invalid info object");
+    return;
+  }
+  try {
+    NC::Info * ci = ncc::extract_info(ci_t);
+    if (!ci->hasHKLInfo()) {
+      ncc::setError("ncrystal_info_gethkl_all called for info object without HKL info");
+      return;
+    }
+    if (ci->hasHKLArrays()) {
+      const NC::HKLArrays& arr = ci->hklArrays();
+      if (h) std::copy(arr.h.begin(),arr.h.end(),h);
+      if (k) std::copy(arr.k.begin(),arr.k.end(),k);
+      if (l) std::copy(arr.l.begin(),arr.l.end(),l);
+      if (multiplicity) std::copy(arr.multiplicity.begin(),arr.multiplicity.end(),multiplicity);
+      if (dspacing) std::copy(arr.dspacing.begin(),arr.dspacing.end(),dspacing);
+      if (fsquared) std::copy(arr.fsquared.begin(),arr.fsquared.end(),fsquared);
+      return;
+    }
+    std::size_t i = 0;
+    for ( auto it = ci->hklBegin(); it != ci->hklEnd(); ++it, ++i ) {
+      if (h) h[i] = it->h;
+      if (k) k[i] = it->k;
+      if (l) l[i] = it->l;
+      if (multiplicity) multiplicity[i] = it->multiplicity;
+      if (dspacing) dspacing[i] = it->dspacing;
+      if (fsquared) fsquared[i] = it->fsquared;
+    }
+  } NCCATCH;
+}
+
+unsigned long ncrystal_info_hkl_nexpanded( ncrystal_info_t ci_t, int* has_demi_normals, int* has_eqv_hkl )
+{
+  *has_demi_normals = 0;
+  *has_eqv_hkl = 0;
+  if (!ncrystal_valid(&ci_t)) {
+    ncc::setError("ncrystal_info_hkl_nexpanded called with invalid info object");
+    return 0;
+  }
+  try {
+    NC::Info * ci = ncc::extract_info(ci_t);
+    if (!ci->hasHKLInfo())
+      return 0;
+    *has_demi_normals = ci->hasHKLDemiNormals() ? 1 : 0;
+    *has_eqv_hkl = ci->hasExpandedHKLInfo() ? 1 : 0;
+    if ( !*has_demi_normals && !*has_eqv_hkl )
+      return 0;
+    if (ci->hasHKLArrays())
+      return ci->hklArrays().normals_offset.back();
+    unsigned long ntot = 0;
+    for ( auto it = ci->hklBegin(); it != ci->hklEnd(); ++it )
+      ntot += it->multiplicity / 2;
+    return ntot;
+  } NCCATCH;
+  return 0;
+}
+
+void ncrystal_info_gethkl_expanded( ncrystal_info_t ci_t,
+                                    unsigned long* offsets,
+                                    double* demi_normals,
+                                    int* eqv_hkl )
+{
+  if (!ncrystal_valid(&ci_t)) {
+    ncc::setError("ncrystal_info_gethkl_expanded called with invalid info object");
+    return;
+  }
+  try {
+    NC::Info * ci = ncc::extract_info(ci_t);
+    const bool has_normals = ci->hasHKLInfo() && ci->hasHKLDemiNormals();
+    const bool has_eqv = ci->hasHKLInfo() && ci->hasExpandedHKLInfo();
+    if ( (demi_normals && !has_normals) || (eqv_hkl && !has_eqv) || (offsets && !has_normals && !has_eqv) ) {
+      ncc::setError("ncrystal_info_gethkl_expanded called for info object without the requested expanded HKL info");
+      return;
+    }
+    if (ci->hasHKLArrays()) {
+      const NC::HKLArrays& arr = ci->hklArrays();
+      if (offsets)
+        std::copy(arr.normals_offset.begin(),arr.normals_offset.end(),offsets);
+      if (demi_normals) {
+        const std::size_t n = arr.normal_x.size();
+        for ( std::size_t j = 0; j < n; ++j ) {
+          *demi_normals++ = arr.normal_x[j];
+          *demi_normals++ = arr.normal_y[j];
+          *demi_normals++ = arr.normal_z[j];
+        }
+      }
+      if (eqv_hkl)
+        std::copy(arr.eqv_hkl.begin(),arr.eqv_hkl.end(),eqv_hkl);
+      return;
+    }
+    unsigned long offset = 0;
+    for ( auto it = ci->hklBegin(); it != ci->hklEnd(); ++it ) {
+      if (offsets)
+        *offsets++ = offset;
+      const unsigned n = it->multiplicity / 2;
+      offset += n;
+      if (demi_normals) {
+        nc_assert_always(it->demi_normals.size()==n);
+        for ( const auto& nn : it->demi_normals ) {
+          *demi_normals++ = nn.x;
+          *demi_normals++ = nn.y;
+          *demi_normals++ = nn.z;
+        }
+      }
+      if (eqv_hkl) {
+        nc_assert_always(it->eqv_hkl);
+        eqv_hkl = std::copy(&it->eqv_hkl[0],&it->eqv_hkl[0]+3*n,eqv_hkl);
+      }
+    }
+    if (offsets)
+      *offsets = offset;
+  } NCCATCH;
+}
 
 unsigned ncrystal_info_ndyninfo( ncrystal_info_t ci_t )
 {
@@ -755,7 +1045,8 @@ void ncrystal_crosssection_nonoriented( ncrystal_process_t o, double ekin, doubl
     return;
   }
   try {
-    *result = process->crossSectionNonOriented(ekin);
+    *result = ncc::memoisedXS( process, ekin, nullptr,
+                               [process,ekin](){ return process->crossSectionNonOriented(ekin); } );
   } NCCATCH;
 }
 
@@ -837,6 +1128,37 @@ void ncrystal_crosssection_nonoriented_many( ncrystal_process_t o,
   } NCCATCH;
 }
 
+void ncrystal_info_searchexpandedhkl_many( ncrystal_info_t ci_t,
+                                            const int * hkl,
+                                            unsigned long n,
+                                            int * results_idx )
+{
+  if (!ncrystal_valid(&ci_t)) {
+    ncc::setError("ncrystal_info_searchexpandedhkl_many called with invalid info object");
+    return;
+  }
+  try {
+    NC::Info * ci = ncc::extract_info(ci_t);
+    if ( !ci->hasHKLInfo() || !ci->hasExpandedHKLInfo() ) {
+      ncc::setError("ncrystal_info_searchexpandedhkl_many called for info object without expanded HKL info");
+      return;
+    }
+    ci->searchExpandedHKLIndices( n, hkl, results_idx );
+  } NCCATCH;
+}
+
+void ncrystal_enable_xsmemo( ncrystal_process_t o, unsigned nentries )
+{
+  NC::Process * process = ncc::extract_process(o);
+  if (!process) {
+    ncc::setError("ncrystal_enable_xsmemo called with invalid object");
+    return;
+  }
+  try {
+    ncc::setXSMemo(process,nentries);
+  } NCCATCH;
+}
+
 void ncrystal_crosssection( ncrystal_process_t o, double ekin, const double (*direction)[3], double* result)
 {
   *result = -1.0;
@@ -846,7 +1168,8 @@ void ncrystal_crosssection( ncrystal_process_t o, double ekin, const double (*di
     return;
   }
   try {
-    double r = process->crossSection( ekin, *direction );
+    double r = ncc::memoisedXS( process, ekin, *direction,
+                                [process,ekin,direction](){ return process->crossSection( ekin, *direction ); } );
     *result = r;
   } NCCATCH;
 }
@@ -24,6 +24,7 @@
 #include "NCrystal/internal/NCMath.hh"
 #include "NCrystal/internal/NCAtomUtils.hh"
 #include "NCrystal/internal/NCLatticeUtils.hh"
+#include "NCrystal/internal/NCSpline.hh"
 #include "NCNXSLib.hh"
 #include <cstdlib>
 #include <cstring>
@@ -76,14 +77,14 @@ namespace NCrystal {
   }
   void deinitNXS_partly(nxs::NXS_UnitCell*uc)
   {
-    if (!uc->hklList)
-      return;
-    nxs::NXS_HKL *it = &(uc->hklList[0]);
-    nxs::NXS_HKL *itE = it + uc->nHKL;
-    for (;it!=itE;++it)
-      free(it->equivHKL);
-    free(uc->hklList);
-    uc->hklList = 0;
+    if (uc->hklList) {
+      nxs::NXS_HKL *it = &(uc->hklList[0]);
+      nxs::NXS_HKL *itE = it + uc->nHKL;
+      for (;it!=itE;++it)
+        free(it->equivHKL);
+      free(uc->hklList);
+      uc->hklList = 0;
+    }
     free(uc->sgInfo.ListSeitzMx);
     uc->sgInfo.ListSeitzMx = 0;
   }
@@ -101,6 +102,10 @@ namespace NCrystal {
       std::memset(&nxs_uc,0,sizeof(nxs_uc));
     }
     double xsectScatNonBragg(const double& lambda) const;
+    double xsectScatNonBraggExact(const double& lambda) const;
+    //Replace analytical evaluations with spline lookups (call once nxs_uc is
+    //fully initialised):
+    void initTables(bool verbose);
     ~XSectProvider_NXS()
     {
       deinitNXS(&nxs_uc);
@@ -108,12 +113,220 @@ namespace NCrystal {
     nxs::NXS_UnitCell nxs_uc;
   private:
     bool m_bkgdlikemcstas;
+    struct Table {
+      double wlmax;
+      SplinedLookupTable spline;
+    };
+    //Tables are ordered by wavelength, and cover [0,m_tables.back().wlmax]
+    //without gaps. Longer wavelengths are evaluated analytically.
+    std::vector<Table> m_tables;
   };
+
+  namespace {
+    class NXSXSectFct final : public Fct1D {
+    public:
+      NXSXSectFct(const XSectProvider_NXS& p) : m_p(p) {}
+      double eval(double wl) const final { return m_p.xsectScatNonBraggExact(wl); }
+    private:
+      const XSectProvider_NXS& m_p;
+    };
+  }
+}
+
+void NCrystal::XSectProvider_NXS::initTables(bool verbose)
+{
+  //The curves are smooth in the wavelength, except for kinks at the edges of
+  //the linear switchover region in nxs_MultiPhonon_COMBINED, which we keep as
+  //boundaries between separate tables. Each table is refined until the
+  //spline reproduces the analytical curves to a relative precision of 1e-6
+  //at all bin centres. Tables are only used for wavelengths up to 100Aa,
+  //which covers all but ultra-cold neutrons.
+  const double wlmax = 100.0;
+  const double tolerance = 1e-6;
+  const unsigned nmin = 128;
+  const unsigned nmax = 1048576;
+
+  m_tables.clear();
+  VectD bounds = { 0.0 };
+  if ( !m_bkgdlikemcstas && nxs_uc.debyeTemp > 0.0 ) {
+    //NB: Same constants as in nxs_MultiPhonon_COMBINED:
+    const double lambda_debye = 30.8106673293723 / std::sqrt( nxs_uc.debyeTemp );
+    for ( auto wl : { lambda_debye * 1.78789683887, lambda_debye * 3.68096408002 } )
+      if ( wl > bounds.back() && wl < wlmax )
+        bounds.push_back( wl );
+  }
+  bounds.push_back( wlmax );
+
+  NXSXSectFct fct(*this);
+  std::vector<Table> tables;
+  tables.reserve( bounds.size()-1 );
+  for ( std::size_t ib = 1; ib < bounds.size(); ++ib ) {
+    const double a = bounds.at(ib-1);
+    const double b = bounds.at(ib);
+    const double h = ncmin( 1e-4, (b-a)*1e-3 );
+    const double fprime_a = estimateSingleSidedDerivative( &fct, a, h );
+    const double fprime_b = estimateSingleSidedDerivative( &fct, b, -h );
+    if ( ncisnan(fprime_a) || ncisnan(fprime_b) )
+      break;
+    bool ok = false;
+    SplinedLookupTable spline;
+    unsigned npts = nmin;
+    for ( ; npts <= nmax && !ok ; npts *= 2 ) {
+      spline.set( &fct, a, b, fprime_a, fprime_b, npts );
+      const double delta = (b-a)/(npts-1);
+      ok = true;
+      for ( unsigned i = 0; i+1 < npts; ++i ) {
+        const double wl = a + (i+0.5)*delta;
+        const double exact = fct.eval( wl );
+        if ( !( ncabs( spline.eval( wl ) - exact ) <= tolerance * exact ) ) {
+          ok = false;
+          break;
+        }
+      }
+    }
+    if (!ok)
+      break;//leave this and longer wavelengths to analytical evaluations
+    if (verbose)
+      std::cout<<"NCrystal::NCNXSFactory::tabulated non-Bragg cross sections for wavelengths ["
+               <<a<<", "<<b<<"] Aa using "<<npts/2<<" points"<<std::endl;
+    tables.push_back( Table{ b, std::move(spline) } );
+  }
+  std::swap( m_tables, tables );
 }
 
 double NCrystal::XSectProvider_NXS::xsectScatNonBragg(const double& lambda) const
 {
+  if ( lambda >= 0.0 ) {
+    for ( auto& t : m_tables ) {
+      if ( lambda <= t.wlmax )
+        return ncmax( 0.0, t.spline.eval(lambda) );
+    }
+  }
+  return xsectScatNonBraggExact(lambda);
+}
 
+namespace NCrystal {
+  namespace {
+    std::vector<HKLInfo> enumerateNXSHKL( nxs::NXS_UnitCell& uc, const RotMatrix& rec_lat,
+                                          double dcutoff_lower_aa, double dcutoff_upper_aa,
+                                          double fsquare_cut, int max_h, int max_k, int max_l )
+    {
+      //Single pass replacement for the hkl list setup in nxs_initHKL, which
+      //loops over all (h,k,l) inside a box of size (2*maxhkl+1)^3, detects
+      //symmetry equivalent planes by pair-wise comparisons with all previously
+      //found planes, and only afterwards filters on d-spacing. Here we instead
+      //apply the d-spacing cuts up front, and pick out exactly one
+      //representative of each family of equivalent planes by checking whether
+      //(h,k,l) is the one which nxs_initHKL would have ended up with (namely the
+      //largest in lexicographical order, among those inside its box).
+      const nxs::T_SgInfo * sg = &uc.sgInfo;
+      int min_h, min_k, min_l;
+      nxs::SetListMin_hkl( sg, max_k, max_l, &min_h, &min_k, &min_l );
+      const bool neg_k_in_box = min_k < 0;
+      const bool neg_l_in_box = min_l < 0;
+      nc_assert_always( min_h == 0 );
+
+      //Atom positions and parameters in structure-of-arrays layout, for the
+      //structure factor loops below:
+      struct AtomType { std::size_t begin, end; double b_iso, b_coh; };
+      std::vector<AtomType> atomtypes;
+      VectD px, py, pz;
+      for ( unsigned i = 0; i < uc.nAtomInfo; ++i ) {
+        const nxs::NXS_AtomInfo& ai = uc.atomInfoList[i];
+        atomtypes.push_back( AtomType{ px.size(), px.size() + ai.nAtoms, ai.B_iso, ai.b_coherent } );
+        for ( unsigned j = 0; j < ai.nAtoms; ++j ) {
+          px.push_back( ai.x[j] );
+          py.push_back( ai.y[j] );
+          pz.push_back( ai.z[j] );
+        }
+      }
+      VectD phases( px.size() );
+
+      //Cuts on d-spacing are first applied on approximate values calculated via
+      //the reciprocal lattice (with a safety margin), and only afterwards on the
+      //values from nxs_calcDhkl:
+      const Vector rl_h = rec_lat * Vector(1,0,0);
+      const Vector rl_k = rec_lat * Vector(0,1,0);
+      const Vector rl_l = rec_lat * Vector(0,0,1);
+      const double kmax = k2Pi / dcutoff_lower_aa;
+      const double kmin = k2Pi / dcutoff_upper_aa;
+      const double ksq_max = kmax * kmax * ( 1.0 + 1e-6 );
+      const double ksq_min = kmin * kmin * ( 1.0 - 1e-6 );
+
+      std::vector<HKLInfo> result;
+      nxs::T_Eq_hkl eq;
+      for ( int h = 0; h <= max_h; ++h ) {
+        for ( int k = ( neg_k_in_box ? -max_k : 0 ); k <= max_k; ++k ) {
+          const Vector khk = rl_h * h + rl_k * k;
+          for ( int l = ( neg_l_in_box ? -max_l : 0 ); l <= max_l; ++l ) {
+            const double ksq = ( khk + rl_l * l ).mag2();
+            if ( ksq > ksq_max || ksq < ksq_min || ( !h && !k && !l ) )
+              continue;
+            int restriction;
+            if ( nxs::IsSysAbsent_hkl( sg, h, k, l, &restriction ) )
+              continue;
+            const int multiplicity = nxs::BuildEq_hkl( sg, &eq, h, k, l );
+            if ( !multiplicity )
+              NCRYSTAL_THROW2(CalcError,"NXS errors while building equivalent hkl planes: \""
+                              <<( nxs::SgError ? nxs::SgError : "" )<<"\"");
+            //Skip unless (h,k,l) is the representative of its family:
+            bool is_representative = true;
+            for ( int i = 0; i < eq.N && is_representative; ++i ) {
+              for ( int sign : { 1, -1 } ) {
+                const int eh( sign * eq.h[i] ), ek( sign * eq.k[i] ), el( sign * eq.l[i] );
+                if ( eh < 0 || ( ek < 0 && !neg_k_in_box ) || ( el < 0 && !neg_l_in_box ) )
+                  continue;//outside box
+                if ( eh > h || ( eh == h && ( ek > k || ( ek == k && el > l ) ) ) ) {
+                  is_representative = false;
+                  break;
+                }
+              }
+            }
+            if ( !is_representative )
+              continue;
+
+            const double dhkl = nxs::nxs_calcDhkl( h, k, l, &uc );
+            if( dhkl < dcutoff_lower_aa || dhkl > dcutoff_upper_aa )
+              continue;
+
+            //Structure factor (as in nxs_calcFSquare):
+            const double dh( k2Pi * h ), dk( k2Pi * k ), dl( k2Pi * l );
+            for ( std::size_t j = 0; j < phases.size(); ++j )
+              phases[j] = px[j] * dh + py[j] * dk + pz[j] * dl;
+            double real( 0.0 ), imag( 0.0 );
+            const double inv4dsq = 0.25 / ( dhkl * dhkl );
+            for ( const auto& at : atomtypes ) {
+              double sum_cos( 0.0 ), sum_sin( 0.0 );
+              for ( std::size_t j = at.begin; j < at.end; ++j ) {
+                sum_cos += std::cos( phases[j] );
+                sum_sin += std::sin( phases[j] );
+              }
+              const double f = std::exp( -at.b_iso * inv4dsq ) * at.b_coh;
+              real += sum_cos * f;
+              imag += sum_sin * f;
+            }
+            const double fsquare = real * real + imag * imag;
+            if( fsquare < fsquare_cut ) //remove reflections with vanishing contribution
+              continue;
+
+            HKLInfo hi;
+            hi.h = h;
+            hi.k = k;
+            hi.l = l;
+            hi.multiplicity = multiplicity;
+            hi.dspacing = dhkl;
+            hi.fsquared = 0.01 * fsquare;
+            result.push_back( std::move(hi) );
+          }
+        }
+      }
+      return result;
+    }
+  }
+}
+
+double NCrystal::XSectProvider_NXS::xsectScatNonBraggExact(const double& lambda) const
+{
   nxs::NXS_UnitCell* ucpar = const_cast<nxs::NXS_UnitCell*>(&nxs_uc);
   double xsect_cell;
   if ( m_bkgdlikemcstas )
@@ -151,9 +364,9 @@ const NCrystal::Info * NCrystal::loadNXSCrystal( const char * nxs_file,
   Info * crystal = new Info();
   RCGuard guard(crystal);//prevent leaks in case of exceptions thrown
 
-  //////////////////////////////////////////////////////////////////
-  // Load and init NXS info (twice to figure out adequate maxhkl) //
-  //////////////////////////////////////////////////////////////////
+  ////////////////////////////
+  // Load and init NXS info //
+  ////////////////////////////
 
   struct NXSXSectProviderWrapper {
     //Dummy struct needed since std::function can only accept copy-able function
@@ -169,10 +382,16 @@ const NCrystal::Info * NCrystal::loadNXSCrystal( const char * nxs_file,
                                            //(NB: Hardcoded to same value as in .ncmat factory).
                                            //factor 100.0 is to convert to nxs units.
 
-  int maxhkl = 1;
-  if (verbose)
-    std::cout<<"NCrystal::NCNXSFactory::calling nxslib initHKL with maxhkl="<<maxhkl<<" (to init non-hkl info)"<<std::endl;
-  initNXS(&nxs_uc, nxs_file, temperature_kelvin, 1, fixpolyatom);
+  //NB: maxhkl=0 means that nxslib will not set up its own hkl list, which we
+  //instead fill directly below.
+  initNXS(&nxs_uc, nxs_file, temperature_kelvin, 0, fixpolyatom);
+
+  xsect_provider.shptr_xsprov_nxs->initTables(verbose);
+  crystal->setXSectProvider(xsect_provider);
+
+  //////////////////////
+  // ... add HKL info //
+  //////////////////////
 
   const bool enable_hkl(dcutoff_lower_aa!=-1);
   if (enable_hkl) {
@@ -194,42 +413,20 @@ const NCrystal::Info * NCrystal::loadNXSCrystal( const char * nxs_file,
 
     int max_h, max_k, max_l;
     estimateHKLRange( dcutoff_lower_aa, rec_lat, max_h, max_k, max_l );
+    ++max_h; ++max_k; ++max_l;//+1 for safety
 
-    maxhkl = ncmax(max_h,ncmax(max_k,max_l)) + 1;//+1 for safety
-    deinitNXS(&nxs_uc);
+    const int maxhkl = ncmax(max_h,ncmax(max_k,max_l));
     if (maxhkl>50)
       NCRYSTAL_THROW2(CalcError,"Combinatorics too great to reach requested dcutoff = "<<dcutoff_lower_aa<<" Aa");
 
     if (verbose)
-      std::cout<<"NCrystal::NCNXSFactory::calling nxslib initHKL with maxhkl="<<maxhkl
-               <<" (for all info including hkl)"<<std::endl;
-    initNXS(&nxs_uc, nxs_file, temperature_kelvin, maxhkl, fixpolyatom );
-  }
-
-  crystal->setXSectProvider(xsect_provider);
-
-  //////////////////////
-  // ... add HKL info //
-  //////////////////////
+      std::cout<<"NCrystal::NCNXSFactory::enumerating hkl planes with |h|<="<<max_h
+               <<", |k|<="<<max_k<<", |l|<="<<max_l<<std::endl;
 
-  if (enable_hkl) {
     crystal->enableHKLInfo(dcutoff_lower_aa,dcutoff_upper_aa);
-    nxs::NXS_HKL *it = &(nxs_uc.hklList[0]);
-    nxs::NXS_HKL *itE = it + nxs_uc.nHKL;
-    for (;it!=itE;++it) {
-      if(it->dhkl < dcutoff_lower_aa || it->dhkl>dcutoff_upper_aa) //cut off d-spacing
-        continue;
-      if(it->FSquare < fsquare_cut) //remove reflections with vanishing contribution (left due to rounding errors?)
-        continue;
-      NCrystal::HKLInfo hi;
-      hi.h = it->h;
-      hi.k = it->k;
-      hi.l = it->l;
-      hi.multiplicity = it->multiplicity;
-      hi.dspacing = it->dhkl;
-      hi.fsquared = 0.01 * it->FSquare;
+    for ( auto& hi : enumerateNXSHKL( nxs_uc, rec_lat, dcutoff_lower_aa, dcutoff_upper_aa,
+                                      fsquare_cut, max_h, max_k, max_l ) )
       crystal->addHKL(std::move(hi));
-    }
     //We used to emit a warning here, but decided not to (user should be allowed
     //to deliberately exclude all bragg edges via the dcutoff parameter without
     //getting warnings):
@@ -844,6 +844,14 @@ int nxs_initHKL( NXS_UnitCell *uc, int fix_incoh_xs )
   /* start calculation of permitted reflections and multiplicities */
   max_hkl = uc->maxHKL_index;
 
+  /* Early return for max_hkl==0 added by NCrystal developers (hkl lists are then provided by the caller): */
+  if( max_hkl == 0 )
+  {
+    uc->nHKL = 0;
+    uc->hklList = NULL;
+    return NXS_ERROR_OK;
+  }
+
   SetListMin_hkl( &SgInfo, max_hkl, max_hkl, &minH, &minK, &minL );
 
   /* how much hkl indices */
@@ -2052,6 +2052,8 @@ int nxs_addAtomInfo( NXS_UnitCell *uc, NXS_AtomInfo ai );
 /* inter-atomic variations in scattering lengths. See:                            */
 /* C. J. Glinka, "Incoherent neutron scattering from multi-element materials",    */
 /* J. Appl. Cryst. (2011). 44, 618-624, https://doi.org/10.1107/S0021889811008223 */
+/* Also added by NCrystal developers: If uc->maxHKL_index is 0, only the average   */
+/* cross-sections are initialised and the hkl list is left empty.                 */
 int nxs_initHKL( NXS_UnitCell *uc, int fix_incoh_xs );
 double nxs_calcDhkl( int h, int k, int l, NXS_UnitCell *uc );
 double nxs_calcFSquare( NXS_HKL *hklReflex, NXS_UnitCell *uc );
@@ -62,6 +62,13 @@ namespace G4NCrystal {
 
     unsigned nMaterialsWithProperties() const { return m_scatters.size(); }
 
+    //Make NCrystal draw random numbers from the G4Random engine of the calling
+    //thread, by binding a forwarding generator as the NCrystal default for
+    //that thread (does nothing if already done in the thread). This is called
+    //automatically by the G4NCrystal processes, but can also be called
+    //explicitly, e.g. from G4UserWorkerInitialization::WorkerStart():
+    static void bindThreadRandomGenerator();
+
     //Translate thrown NCrystal exceptions to G4Exception(..) calls (id should
     //be unique and fixed for each call location):
     static void handleError( const char*origin, unsigned id,
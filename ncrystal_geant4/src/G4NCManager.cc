@@ -34,7 +34,8 @@
 
 namespace G4NCrystal {
   class G4WrappedRandGen  : public NCrystal::RandomBase {
-    //Wraps G4's random stream for NCrystal usage.
+    //Wraps G4's random stream for NCrystal usage (in multi-threaded Geant4
+    //builds, G4UniformRand() uses the engine of the calling thread).
   public:
     G4WrappedRandGen() {}
     virtual double generate() { return G4UniformRand(); }
@@ -100,6 +101,15 @@ void G4NCrystal::Manager::addScatterProperty(G4Material* mat,const NCrystal::Sca
   matprop->AddConstProperty(m_key.c_str(), idx);
 }
 
+void G4NCrystal::Manager::bindThreadRandomGenerator()
+{
+  static thread_local bool s_bound = false;
+  if (s_bound)
+    return;
+  s_bound = true;
+  NCrystal::setThreadDefaultRandomGenerator(new G4WrappedRandGen);
+}
+
 void G4NCrystal::Manager::cleanup(bool removeFactories)
 {
   if (s_mgr) {
@@ -32,6 +32,81 @@
 #include "G4ParticleChange.hh"
 #include "G4VTouchable.hh"
 #include "G4NavigationHistory.hh"
+#include <algorithm>
+#include <cmath>
+
+namespace G4NCrystal {
+  namespace {
+
+    //Energy range [eV] of cross section tables (below the range, cross
+    //sections are evaluated directly, above it the wrapped process is used):
+    const double s_tableEmin = 1e-5;
+    const double s_tableEmax = 5.0;
+
+    //Adaptive table construction: bisect intervals until linear interpolation
+    //is accurate at the midpoint and quarter points (checking a single point
+    //can miss pairs of Bragg edges), or the interval is too narrow (at Bragg
+    //edges). The total number of points per table is capped:
+    const double s_tableRelTol = 1e-3;
+    const double s_tableMinRelWidth = 1e-6;
+    const unsigned s_tableInitialPointsPerDecade = 20;
+    const std::size_t s_tableMaxPoints = 200000;
+
+    bool refineXSTable( const NCrystal::Scatter& scat,
+                        double e0, double xs0, double e1, double xs1,
+                        std::vector<double>& energies, std::vector<double>& xsvals )
+    {
+      //Appends points in (e0,e1], assuming e0 is already added. Returns false
+      //without appending anything if the cap on the number of points is
+      //reached (all points appended before then are in converged intervals):
+      if ( energies.size() >= s_tableMaxPoints )
+        return false;
+      const double emid = 0.5 * ( e0 + e1 );
+      if ( e1 - e0 > s_tableMinRelWidth * emid ) {
+        const double xsmid = scat.crossSectionNonOriented( emid );
+        bool accurate = true;
+        for ( unsigned i = 1; accurate && i < 4; ++i ) {
+          const double f = 0.25 * i;
+          const double xs = ( i == 2 ? xsmid : scat.crossSectionNonOriented( e0 + f * ( e1 - e0 ) ) );
+          const double xslin = xs0 + f * ( xs1 - xs0 );
+          accurate = std::abs( xs - xslin ) <= s_tableRelTol * std::max( xs, xslin );
+        }
+        if ( !accurate )
+          return ( refineXSTable( scat, e0, xs0, emid, xsmid, energies, xsvals )
+                   && refineXSTable( scat, emid, xsmid, e1, xs1, energies, xsvals ) );
+      }
+      energies.push_back( e1 );
+      xsvals.push_back( xs1 );
+      return true;
+    }
+
+    //Build table in [s_tableEmin,s_tableEmax]. Returns false if the cap on the
+    //number of points was reached, in which case the table only extends up to
+    //the last converged energy (energies.back()):
+    bool buildXSTable( const NCrystal::Scatter& scat,
+                       std::vector<double>& energies, std::vector<double>& xsvals )
+    {
+      energies.clear();
+      xsvals.clear();
+      const double ndecades = std::log10( s_tableEmax / s_tableEmin );
+      const unsigned ninitial = std::max<unsigned>( 2, unsigned( ndecades * s_tableInitialPointsPerDecade + 1.5 ) );
+      const double ratio = std::pow( s_tableEmax / s_tableEmin, 1.0 / ( ninitial - 1 ) );
+      double e0 = s_tableEmin;
+      double xs0 = scat.crossSectionNonOriented( e0 );
+      energies.push_back( e0 );
+      xsvals.push_back( xs0 );
+      for ( unsigned i = 1; i < ninitial; ++i ) {
+        const double e1 = ( i + 1 == ninitial ? s_tableEmax : e0 * ratio );
+        const double xs1 = scat.crossSectionNonOriented( e1 );
+        if ( !refineXSTable( scat, e0, xs0, e1, xs1, energies, xsvals ) )
+          return false;
+        e0 = e1;
+        xs0 = xs1;
+      }
+      return true;
+    }
+  }
+}
 
 G4NCrystal::ProcWrapper::ProcWrapper(G4HadronElasticProcess * procToWrap,
     const G4String& processName)
@@ -46,6 +121,11 @@ G4NCrystal::ProcWrapper::~ProcWrapper()
 {
 }
 
+void G4NCrystal::ProcWrapper::clearTables()
+{
+  m_xsTables.reset();
+}
+
 G4VParticleChange* G4NCrystal::ProcWrapper::PostStepDoIt(const G4Track& trk, const G4Step& step)
 {
   nc_assert(trk.GetParticleDefinition()->GetPDGEncoding()==2112);
@@ -66,7 +146,9 @@ G4VParticleChange* G4NCrystal::ProcWrapper::PostStepDoIt(const G4Track& trk, con
     return m_wrappedProc->PostStepDoIt(trk,step);
 
 
-  //Let the NCrystal::Scatter instance do its work!
+  //Let the NCrystal::Scatter instance do its work (with random numbers from
+  //the G4 engine of this thread)!
+  Manager::bindThreadRandomGenerator();
 
   constexpr double inv_eV = 1.0/CLHEP::eV;
   double ekin_eV = ekin * inv_eV;//NCrystal unit is eV
@@ -103,6 +185,21 @@ G4double G4NCrystal::ProcWrapper::GetMeanFreePath(const G4Track& trk, G4double p
   if ( ekin > 5*CLHEP::eV || !ekin || !(scat=m_mgr->getScatterProperty(trk.GetMaterial())) )
     return m_wrappedProc->GetMeanFreePath(trk,p,f);
 
+  G4Material * mat = trk.GetMaterial();
+  const std::size_t imat = mat->GetIndex();
+  if ( m_xsTables && imat < m_xsTables->size() ) {
+    const XSTable& table = (*m_xsTables)[imat];
+    if ( !table.energies.empty() && ekin >= table.energies.front() && ekin <= table.energies.back() ) {
+      //Linear interpolation in macroscopic cross sections:
+      auto it = std::upper_bound( table.energies.begin(), table.energies.end(), ekin );
+      const std::size_t i1 = ( it == table.energies.end() ? table.energies.size() - 1 : it - table.energies.begin() );
+      const std::size_t i0 = i1 - 1;
+      const double e0 = table.energies[i0], e1 = table.energies[i1];
+      const double macroxs = table.macroxs[i0] + ( ekin - e0 ) * ( table.macroxs[i1] - table.macroxs[i0] ) / ( e1 - e0 );
+      return macroxs > 0.0 ? 1.0 / macroxs : kInfinity;
+    }
+  }
+
   double ekin_eV = ekin * (1.0/CLHEP::eV);//NCrystal unit is eV
   const G4ThreeVector& indir = trk.GetMomentumDirection();
 
@@ -119,12 +216,61 @@ G4double G4NCrystal::ProcWrapper::GetMeanFreePath(const G4Track& trk, G4double p
   }
 
   return xs
-      ? 1.0 / ( trk.GetMaterial()->GetTotNbOfAtomsPerVolume() * xs )
+      ? 1.0 / ( mat->GetTotNbOfAtomsPerVolume() * xs )
           : kInfinity ;
 }
 
 void G4NCrystal::ProcWrapper::BuildPhysicsTable(const G4ParticleDefinition&)
 {
+  Manager::bindThreadRandomGenerator();
+  clearTables();
+  const G4MaterialTable * mattable = G4Material::GetMaterialTable();
+  auto tables = std::make_shared<std::vector<XSTable>>( mattable->size() );
+  std::vector<double> energies, xsvals;
+  for ( std::size_t i = 0; i < mattable->size(); ++i ) {
+    G4Material * mat = (*mattable)[i];
+    const NCrystal::Scatter* scat = m_mgr->getScatterProperty(mat);
+    if ( !scat || scat->isOriented() )
+      continue;
+    bool complete(false);
+    try {
+      complete = buildXSTable( *scat, energies, xsvals );
+    } catch ( NCrystal::Error::Exception& e ) {
+      Manager::handleError("G4NCrystal::ProcWrapper::BuildPhysicsTable",103,e);
+    }
+    if ( !complete && !energies.empty() ) {
+      G4cout << "G4NCrystal WARNING :: Cross section table for material "<<mat->GetName()
+             <<" reached the maximum of "<<s_tableMaxPoints<<" points before converging. The table is only used"
+             <<" up to "<<energies.back()<<" eV, cross sections at higher energies are evaluated directly."<<G4endl;
+    }
+    if ( energies.size() < 2 )
+      continue;
+    const double natoms = mat->GetTotNbOfAtomsPerVolume();
+    XSTable& table = (*tables)[mat->GetIndex()];
+    table.energies.reserve( energies.size() );
+    table.macroxs.reserve( energies.size() );
+    for ( std::size_t j = 0; j < energies.size(); ++j ) {
+      table.energies.push_back( energies[j] * CLHEP::eV );
+      table.macroxs.push_back( natoms * xsvals[j] * CLHEP::barn );
+    }
+    if (verboseLevel>1)
+      G4cout << "G4NCrystal ProcWrapper built cross section table with "<<energies.size()
+             <<" points for material "<<mat->GetName()<< G4endl;
+  }
+  m_xsTables = std::move(tables);
+}
+
+void G4NCrystal::ProcWrapper::BuildWorkerPhysicsTable(const G4ParticleDefinition& pd)
+{
+  //In multi-threaded mode, share the (read-only) tables built by the master
+  //process rather than rebuilding identical tables on each worker thread:
+  const ProcWrapper * master = dynamic_cast<const ProcWrapper*>( GetMasterProcess() );
+  if ( master && master != this && master->m_xsTables ) {
+    Manager::bindThreadRandomGenerator();
+    m_xsTables = master->m_xsTables;
+    return;
+  }
+  BuildPhysicsTable(pd);
 }
 
 G4bool G4NCrystal::ProcWrapper::IsApplicable(const G4ParticleDefinition& pd)
@@ -23,6 +23,8 @@
 
 #include "G4VDiscreteProcess.hh"
 #include "G4ParticleChange.hh"
+#include <vector>
+#include <memory>
 
 class G4HadronElasticProcess;
 class G4Material;
@@ -35,6 +37,17 @@ namespace G4NCrystal {
   {
     // Wrapper process used by G4NCInstall to dynamically support NCrystal
     // physics with any physics model.
+    //
+    // For materials with non-oriented NCrystal scatter properties, tables of
+    // macroscopic cross sections are built in BuildPhysicsTable, with energy
+    // points placed adaptively until linear interpolation reproduces the
+    // NCrystal cross sections within a relative tolerance of 1e-3 (or until
+    // intervals are narrower than 1e-6 relative, which resolves Bragg
+    // edges). Mean free paths are then obtained by interpolation in these
+    // tables, while oriented materials keep evaluating cross sections
+    // directly. If a table reaches the cap on its number of points, a warning
+    // is printed and the table is only used below the last converged energy.
+    // In multi-threaded mode, worker threads share the tables of the master.
 
   public:
     ProcWrapper(G4HadronElasticProcess * procToWrap,
@@ -47,14 +60,21 @@ namespace G4NCrystal {
     virtual G4double GetMeanFreePath(const G4Track&, G4double, G4ForceCondition*);
 
     virtual void BuildPhysicsTable(const G4ParticleDefinition&);
+    virtual void BuildWorkerPhysicsTable(const G4ParticleDefinition&);
     virtual G4bool IsApplicable(const G4ParticleDefinition& pd);
 
   private:
     ProcWrapper(ProcWrapper&);
     ProcWrapper& operator=(const ProcWrapper&);
+    void clearTables();
     G4ParticleChange m_particleChange;
     G4HadronElasticProcess * m_wrappedProc;
     Manager * m_mgr;
+    struct XSTable {
+      std::vector<double> energies;//empty if not tabulated
+      std::vector<double> macroxs;
+    };
+    std::shared_ptr<const std::vector<XSTable>> m_xsTables;//indexed by material index, shared with workers
   };
 
 }
@@ -345,6 +345,47 @@ def _load(nclib_filename):
     _wrap('ncrystal_info_gethkl',None,(ncrystal_info_t,_int,_intp,_intp,_intp,_intp,_dblp,_dblp))
     _wrap('ncrystal_info_dspacing_from_hkl',_dbl,(ncrystal_info_t,_int,_int,_int))
     functions['ncrystal_info_gethkl_setuppars'] = lambda : (_int(),_int(),_int(),_int(),_dbl(),_dbl())
+    _raw_gethkl_all = _wrap('ncrystal_info_gethkl_all',None,(ncrystal_info_t,_intp,_intp,_intp,_intp,_dblp,_dblp),hide=True)
+    def ncrystal_info_gethkl_all(nfo):
+        _ensure_numpy()
+        n = functions['ncrystal_info_nhkl'](nfo)
+        nc_assert(n>=0,'HKL info not available')
+        ints = [ _np.empty(n,dtype=_int) for i in range(4) ]
+        dbls = [ _np.empty(n,dtype=_dbl) for i in range(2) ]
+        _raw_gethkl_all(nfo,*([a.ctypes.data_as(_intp) for a in ints]+[ndarray_to_dblp(a) for a in dbls]))
+        res = _np.empty(n,dtype=[('h',_int),('k',_int),('l',_int),('multiplicity',_int),
+                                  ('dspacing',_dbl),('fsquared',_dbl)])
+        for name,a in zip(('h','k','l','multiplicity','dspacing','fsquared'),ints+dbls):
+            res[name] = a
+        return res
+    functions['ncrystal_info_gethkl_all'] = ncrystal_info_gethkl_all
+    _raw_hkl_nexpanded = _wrap('ncrystal_info_hkl_nexpanded',ctypes.c_ulong,(ncrystal_info_t,_intp,_intp),hide=True)
+    _raw_gethkl_expanded = _wrap('ncrystal_info_gethkl_expanded',None,(ncrystal_info_t,ctypes.POINTER(ctypes.c_ulong),
+                                                                        _dblp,_intp),hide=True)
+    def ncrystal_info_gethkl_expanded(nfo):
+        _ensure_numpy()
+        n = functions['ncrystal_info_nhkl'](nfo)
+        nc_assert(n>=0,'HKL info not available')
+        has_normals, has_eqv = _int(), _int()
+        ntot = int(_raw_hkl_nexpanded(nfo,has_normals,has_eqv))
+        if not has_normals.value and not has_eqv.value:
+            return None, None, None
+        offsets = _np.empty(n+1,dtype=ctypes.c_ulong)
+        normals = _np.empty((ntot,3),dtype=_dbl) if has_normals.value else None
+        eqv_hkl = _np.empty((ntot,3),dtype=_int) if has_eqv.value else None
+        _raw_gethkl_expanded(nfo,offsets.ctypes.data_as(ctypes.POINTER(ctypes.c_ulong)),
+                             None if normals is None else ndarray_to_dblp(normals),
+                             None if eqv_hkl is None else eqv_hkl.ctypes.data_as(_intp))
+        return offsets, normals, eqv_hkl
+    functions['ncrystal_info_gethkl_expanded'] = ncrystal_info_gethkl_expanded
+    _raw_searchhkl_many = _wrap('ncrystal_info_searchexpandedhkl_many',None,(ncrystal_info_t,_intp,ctypes.c_ulong,_intp),hide=True)
+    def ncrystal_info_searchexpandedhkl_many(nfo,hkl):
+        _ensure_numpy()
+        hkl = _np.ascontiguousarray(hkl,dtype=_int).reshape(-1,3)
+        res = _np.empty(len(hkl),dtype=_int)
+        _raw_searchhkl_many(nfo,hkl.ctypes.data_as(_intp),len(hkl),res.ctypes.data_as(_intp))
+        return res
+    functions['ncrystal_info_searchexpandedhkl_many'] = ncrystal_info_searchexpandedhkl_many
 
     _wrap('ncrystal_info_ndyninfo',_uint,(ncrystal_info_t,))
     _raw_di_base = _wrap('ncrystal_dyninfo_base',None,(ncrystal_info_t,_uint,_dblp,_uintp,_dblp,_uintp),hide=True)
@@ -506,6 +547,8 @@ def _load(nclib_filename):
         return res.value
     functions['ncrystal_crosssection'] = ncrystal_crosssection
 
+    _wrap('ncrystal_enable_xsmemo',None,(ncrystal_process_t,_uint))
+
     _raw_gs = _wrap('ncrystal_genscatter',None,(ncrystal_scatter_t,_dbl,_dbl*3,_dbl*3,_dblp),hide=True)
     _raw_gs_many = _wrap('ncrystal_genscatter_many',None,(ncrystal_scatter_t,_dbl,_dbl*3,
                                                           ctypes.c_ulong,_dblp,_dblp,_dblp,_dblp),hide=True)
@@ -1016,6 +1059,27 @@ class Info(RCBase):
         for idx in range(self.nHKL()):
             _rawfct['ncrystal_info_gethkl'](self._rawobj,idx,h,k,l,mult,dsp,fsq)
             yield h.value,k.value,l.value,mult.value,dsp.value,fsq.value
+    def hklArray(self):
+        """Get all HKL info at once as a numpy structured array, with fields
+        h, k, l, multiplicity, dspacing and fsquared (one entry per entry in
+        hklList()). Requires numpy."""
+        nc_assert(self.hasHKLInfo())
+        return _rawfct['ncrystal_info_gethkl_all'](self._rawobj)
+    def hklExpandedArrays(self):
+        """Get expanded HKL info at once as a tuple of numpy arrays,
+        (offsets,demi_normals,eqv_hkl). The demi_normals and eqv_hkl arrays
+        have shape (n,3), and rows [offsets[i],offsets[i+1]) belong to entry i
+        in hklList(). Entries which are not available are None. Requires
+        numpy."""
+        nc_assert(self.hasHKLInfo())
+        return _rawfct['ncrystal_info_gethkl_expanded'](self._rawobj)
+    def searchExpandedHKL(self, hkl):
+        """Look up Miller indices in the lists of equivalent HKL values of each
+        HKL plane (also matching (-h,-k,-l)). The hkl parameter can be a single
+        (h,k,l) tuple or an array of shape (n,3), and a numpy array of indices
+        into hklList() is returned, with -1 for entries not found. Requires
+        expanded HKL information and numpy."""
+        return _rawfct['ncrystal_info_searchexpandedhkl_many'](self._rawobj,hkl)
     def dspacingFromHKL(self, h, k, l):
         """Convenience method, calculating the d-spacing of a given Miller
         index. Calling this incurs the overhead of creating a reciprocal lattice
@@ -1291,6 +1355,13 @@ class Process(CalcBase):
     def crossSection( self, ekin, direction ):
         """Access cross sections."""
         return _rawfct['ncrystal_crosssection'](self._rawobj,ekin, direction)
+    def enableXSMemo( self, nentries = 4 ):
+        """Memoise the results of the last nentries (max 64) cross section
+        queries with this object on the current thread, so exactly repeated
+        queries are answered without recomputation. Other threads are not
+        affected and must enable their own memo. Use nentries=0 to disable
+        (again only on the current thread)."""
+        _rawfct['ncrystal_enable_xsmemo'](self._rawobj,nentries)
     def crossSectionNonOriented( self, ekin, repeat = None ):
         """Access cross sections (should not be called for oriented processes).
 
@@ -1496,8 +1567,9 @@ def formatVectorForNCMAT(name,values):
 def setDefaultRandomGenerator(rg):
     """Set the default random generator for CalcBase classes.
 
-    Note that this can only changes the random generator for those CalcBase
-    instances that did not already use random numbers). Default generator when
+    This changes the random generator for all CalcBase instances which did not
+    have a generator set explicitly (including those which already used random
+    numbers). Default generator when
     using the NCrystal python interface is the scientifically sound
     random.random stream from the python standard library (a Mersenne Twister).
     """